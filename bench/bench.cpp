@@ -0,0 +1,332 @@
+// dawglog_bench: micro-benchmarks of the logging backend
+//
+// usage: dawglog_bench [SECTION...]
+//
+// Sections:
+//   wait   wake-up latency vs. writer CPU use of the target queue wait strategies
+//   batch  throughput of Logger::log() vs. LogBatch into a file sink
+//   span   cost of a DAWGLOG_SPAN when its level is filtered out and when it is written
+//   static cost per record of Logger vs. StaticLogger with the same sink and formatter
+//   format throughput of a queued JSON target with several producers, by number of format workers
+//   payload 64 KiB bodies into a file sink, formatted into the message vs. passed to log_payload()
+//   bytes  hex/base64 encoding speed of a per-byte "{:02x}" loop vs. DawgLog::bytes()
+#include <dawg-log/logger.hpp>
+#include <dawg-log/formatters/json_formatter.hpp>
+#include <dawg-log/formatters/text_formatter.hpp>
+#include <dawg-log/sinks/file_sink.hpp>
+#include <dawg-log/target_queue.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+
+namespace dog = DawgLog;
+
+namespace {
+std::uint64_t thread_cpu_ns() {
+    timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+// Records the delay between creating a record and the writer thread handing it to the sink
+struct LatencySink : dog::Sink {
+    void write(const dog::Record& r, std::string_view) override {
+        const auto now = dog::monotonic_ns();
+        latencies.push_back(now - r.mono_ns);
+        const auto cpu = thread_cpu_ns();
+        if (latencies.size() == 1) {
+            first_cpu = cpu;
+            first_wall = now;
+        }
+        last_cpu = cpu;
+        last_wall = now;
+    }
+
+    std::vector<std::uint64_t> latencies;
+    std::uint64_t first_cpu{0};
+    std::uint64_t last_cpu{0};
+    std::uint64_t first_wall{0};
+    std::uint64_t last_wall{0};
+};
+
+double percentile_us(std::vector<std::uint64_t> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    const auto idx = static_cast<std::size_t>(p * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(idx), values.end());
+    return static_cast<double>(values[idx]) / 1000.0;
+}
+
+void bench_wait_strategies() {
+    constexpr int kRecords = 1000;
+    constexpr auto kGap = std::chrono::microseconds(200);
+    const std::pair<const char*, dog::BackendOptions::Wait> strategies[] = {
+        {"spin", dog::BackendOptions::Wait::SPIN},
+        {"spin_yield", dog::BackendOptions::Wait::SPIN_YIELD},
+        {"condvar", dog::BackendOptions::Wait::CONDVAR},
+        {"sleep", dog::BackendOptions::Wait::SLEEP},
+    };
+    const auto tag = dog::TagRegistry::intern("bench");
+
+    std::cout << fmt::format("wait strategies: {} records, one every {} us\n", kRecords, kGap.count());
+    std::cout << fmt::format("{:<12}{:>10}{:>10}{:>10}{:>14}\n", "strategy", "p50 us", "p99 us", "max us",
+                             "writer cpu %");
+    for (const auto& [name, wait] : strategies) {
+        LatencySink sink;
+        {
+            dog::TargetQueue::Options options;
+            options.backend.wait = wait;
+            dog::TargetQueue queue(sink, options);
+            for (int i = 0; i < kRecords; ++i) {
+                queue.push(dog::Record{dog::LogLevel::info, tag, LOG_SRC, "bench", "wake up"}, {});
+                std::this_thread::sleep_for(kGap);
+            }
+            queue.flush();
+        }
+        const auto wall = static_cast<double>(sink.last_wall - sink.first_wall);
+        const auto cpu = static_cast<double>(sink.last_cpu - sink.first_cpu);
+        std::cout << fmt::format("{:<12}{:>10.1f}{:>10.1f}{:>10.1f}{:>14.1f}\n", name,
+                                 percentile_us(sink.latencies, 0.5), percentile_us(sink.latencies, 0.99),
+                                 percentile_us(sink.latencies, 1.0), wall > 0 ? 100.0 * cpu / wall : 0.0);
+    }
+}
+
+void bench_batch() {
+    constexpr int kRecords = 200000;
+    const std::string path = "dawglog_bench_batch.log";
+    const auto tag = dog::TagRegistry::intern("bench");
+    std::vector<dog::Logger::Target> targets;
+    targets.emplace_back(dog::Logger::Target{std::make_unique<dog::FileSink>(path),
+                                             std::make_unique<dog::TextFormatter>()});
+    dog::Config cfg{"config.json"};
+    cfg.level = dog::LogLevel::info;
+    dog::Logger::init(cfg, std::move(targets));
+    auto& logger = dog::Logger::instance();
+
+    const auto rate = [](std::chrono::steady_clock::duration elapsed) {
+        return kRecords / std::chrono::duration<double>(elapsed).count();
+    };
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRecords; ++i) {
+        logger.log(dog::LogLevel::info, tag, LOG_SRC, "row {} loaded ({} bytes)", i, i * 3);
+    }
+    const auto single = rate(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    {
+        auto b = logger.batch(tag);
+        for (int i = 0; i < kRecords; ++i) {
+            b.info(LOG_SRC, "row {} loaded ({} bytes)", i, i * 3);
+        }
+    }
+    const auto batched = rate(std::chrono::steady_clock::now() - start);
+
+    std::cout << fmt::format("batch: {} records into a file sink\n", kRecords);
+    std::cout << fmt::format("{:<12}{:>16}\n", "api", "records/s");
+    std::cout << fmt::format("{:<12}{:>16.0f}\n", "log()", single);
+    std::cout << fmt::format("{:<12}{:>16.0f}\n", "LogBatch", batched);
+    std::remove(path.c_str());
+}
+
+// Discards records, so the span benchmark measures the logging path only
+struct NullSink : dog::Sink {
+    void write(const dog::Record&, std::string_view) override {}
+};
+
+void bench_spans() {
+    constexpr int kSpans = 1000000;
+    std::vector<dog::Logger::Target> targets;
+    targets.emplace_back(dog::Logger::Target{std::make_unique<NullSink>(), std::make_unique<dog::TextFormatter>()});
+    dog::Config cfg{"config.json"};
+    dog::Logger::init(cfg, std::move(targets));
+    auto& logger = dog::Logger::instance();
+    dog::TaggedLogger spans("bench");
+
+    const auto per_span_ns = [&] {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kSpans; ++i) {
+            DAWGLOG_SPAN(spans, "step");
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kSpans;
+    };
+    logger.set_level(dog::LogLevel::warning);
+    const auto filtered = per_span_ns();
+    logger.set_level(dog::LogLevel::debug);
+    const auto written = per_span_ns();
+
+    std::cout << fmt::format("span: {} spans into a null sink\n", kSpans);
+    std::cout << fmt::format("{:<12}{:>16}\n", "level", "ns/span");
+    std::cout << fmt::format("{:<12}{:>16.1f}\n", "filtered", filtered);
+    std::cout << fmt::format("{:<12}{:>16.1f}\n", "written", written);
+}
+
+// Formats like the text formatter would in size, without the cost of a real formatter
+struct PlainFormatter : dog::Formatter {
+    std::string format(const dog::Record& r) override { return std::string(r.message); }
+};
+
+void bench_static_logger() {
+    constexpr int kRecords = 1000000;
+    std::vector<dog::Logger::Target> targets;
+    for (int i = 0; i < 2; ++i) {
+        targets.emplace_back(dog::Logger::Target{std::make_unique<NullSink>(), std::make_unique<PlainFormatter>()});
+    }
+    dog::Logger::init(dog::Config{"config.json"}, std::move(targets));
+    dog::TaggedLogger dynamic("bench");
+    dog::StaticLogger<dog::StaticTarget<NullSink, PlainFormatter>, dog::StaticTarget<NullSink, PlainFormatter>> fixed{
+        "bench"};
+    auto fixed_tag = fixed.tagged("bench");
+
+    const auto per_record_ns = [&](auto& logger) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kRecords; ++i) {
+            logger.info(LOG_SRC, "record {}", i);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kRecords;
+    };
+    const auto dynamic_ns = per_record_ns(dynamic);
+    const auto static_ns = per_record_ns(fixed_tag);
+
+    std::cout << fmt::format("static: {} records, two targets with null sinks\n", kRecords);
+    std::cout << fmt::format("{:<14}{:>16}\n", "logger", "ns/record");
+    std::cout << fmt::format("{:<14}{:>16.1f}\n", "Logger", dynamic_ns);
+    std::cout << fmt::format("{:<14}{:>16.1f}\n", "StaticLogger", static_ns);
+}
+}
+
+void bench_format_workers() {
+    constexpr int kProducers = 4;
+    constexpr int kRecordsPerProducer = 100000;
+    std::cout << fmt::format("format: {} producers x {} records, queued json target with a null sink\n",
+                             kProducers, kRecordsPerProducer);
+    std::cout << fmt::format("{:<16}{:>16}\n", "format workers", "records/s");
+    for (const std::size_t workers : {std::size_t{0}, std::size_t{1}, std::size_t{4}}) {
+        dog::Logger::Target target{std::make_unique<NullSink>(), std::make_unique<dog::JsonFormatter>()};
+        dog::TargetQueue::Options options;
+        options.capacity = 65536;
+        options.max_bytes = 64 << 20;
+        options.overflow = dog::TargetQueue::Overflow::BLOCK;
+        options.format_workers = workers;
+        target.queue = std::make_unique<dog::TargetQueue>(*target.sink, options, target.formatter.get());
+        std::vector<dog::Logger::Target> targets;
+        targets.push_back(std::move(target));
+        dog::Logger::init(dog::Config{"config.json"}, std::move(targets));
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([p] {
+                dog::TaggedLogger log("bench");
+                for (int i = 0; i < kRecordsPerProducer; ++i) {
+                    log.info(LOG_SRC, "producer {} request {} served in {} us", p, i, i % 977);
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        dog::Logger::instance().flush();
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << fmt::format("{:<16}{:>16.0f}\n", workers == 0 ? "0 (producers)" : std::to_string(workers),
+                                 kProducers * kRecordsPerProducer / elapsed);
+    }
+}
+
+void bench_payload() {
+    constexpr int kRecords = 5000;
+    const std::string path = "dawglog_bench_payload.log";
+    const std::string body(64 * 1024, 'b');
+    std::vector<dog::Logger::Target> targets;
+    targets.emplace_back(dog::Logger::Target{std::make_unique<dog::FileSink>(path),
+                                             std::make_unique<dog::TextFormatter>()});
+    dog::Logger::init(dog::Config{"config.json"}, std::move(targets));
+    dog::TaggedLogger log("bench");
+
+    const auto per_record_us = [](auto&& emit) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kRecords; ++i) {
+            emit(i);
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / kRecords;
+    };
+    const auto in_message = per_record_us([&](int i) { log.info(LOG_SRC, "POST /upload {} {}", i, body); });
+    const auto as_payload = per_record_us([&](int i) {
+        log.payload(dog::LogLevel::info, LOG_SRC, body, "POST /upload {}", i);
+    });
+
+    std::cout << fmt::format("payload: {} records with a {} byte body into a file sink\n", kRecords, body.size());
+    std::cout << fmt::format("{:<14}{:>16}\n", "api", "us/record");
+    std::cout << fmt::format("{:<14}{:>16.2f}\n", "log()", in_message);
+    std::cout << fmt::format("{:<14}{:>16.2f}\n", "log_payload()", as_payload);
+    std::remove(path.c_str());
+}
+
+void bench_bytes() {
+    constexpr int kRounds = 2000;
+    std::vector<std::uint8_t> data(4096);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<std::uint8_t>(i * 131);
+    }
+    const auto mb_per_s = [&](auto&& encode) {
+        fmt::memory_buffer out;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kRounds; ++i) {
+            out.clear();
+            encode(out);
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(data.size()) * kRounds / elapsed.count() / 1e6;
+    };
+    const auto loop = mb_per_s([&](fmt::memory_buffer& out) {
+        for (const auto b : data) {
+            fmt::format_to(std::back_inserter(out), "{:02x}", b);
+        }
+    });
+    const auto hex = mb_per_s([&](fmt::memory_buffer& out) { fmt::format_to(std::back_inserter(out), "{}", dog::bytes(data)); });
+    const auto base64 = mb_per_s([&](fmt::memory_buffer& out) {
+        fmt::format_to(std::back_inserter(out), "{:b}", dog::bytes(data));
+    });
+
+    std::cout << fmt::format("bytes: encoding a {} byte buffer\n", data.size());
+    std::cout << fmt::format("{:<16}{:>16}\n", "encoder", "input MB/s");
+    std::cout << fmt::format("{:<16}{:>16.0f}\n", "{:02x} loop", loop);
+    std::cout << fmt::format("{:<16}{:>16.0f}\n", "bytes() hex", hex);
+    std::cout << fmt::format("{:<16}{:>16.0f}\n", "bytes() base64", base64);
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> sections(argv + 1, argv + argc);
+    const auto selected = [&](const std::string& name) {
+        return sections.empty() || std::find(sections.begin(), sections.end(), name) != sections.end();
+    };
+    if (selected("wait")) {
+        bench_wait_strategies();
+    }
+    if (selected("batch")) {
+        bench_batch();
+    }
+    if (selected("span")) {
+        bench_spans();
+    }
+    if (selected("static")) {
+        bench_static_logger();
+    }
+    if (selected("format")) {
+        bench_format_workers();
+    }
+    if (selected("payload")) {
+        bench_payload();
+    }
+    if (selected("bytes")) {
+        bench_bytes();
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+// Call sites compiled by the dawglog_size_report target.
+//
+// The same file is built twice: once with the type-erased Logger::vlog path and once
+// with DAWGLOG_INLINE_LOG, which inlines locking, formatting and the target loop into
+// every Logger::log instantiation. `size` of the two objects shows the code each log
+// call site costs.
+#include <dawg-log/logger.hpp>
+#include <cstdint>
+#include <string>
+
+namespace dog = DawgLog;
+
+namespace {
+dog::TaggedLogger net("net");
+dog::TaggedLogger db("db");
+}
+
+void size_report_calls(int i, unsigned u, std::int64_t l, double d, float f, bool b, char c,
+                       const char* cs, const std::string& s, const void* p) {
+    TAG_DEBUG(net, "int {}", i);
+    TAG_INFO(net, "unsigned {}", u);
+    TAG_NOTICE(net, "int64 {}", l);
+    TAG_WARNING(net, "double {:.3f}", d);
+    TAG_ERROR(net, "float {}", f);
+    TAG_CRITICAL(net, "bool {}", b);
+    TAG_DEBUG(db, "char {}", c);
+    TAG_INFO(db, "cstr {}", cs);
+    TAG_NOTICE(db, "string {}", s);
+    TAG_WARNING(db, "pointer {}", p);
+    TAG_ERROR(db, "int {} double {}", i, d);
+    TAG_CRITICAL(db, "string {} int64 {}", s, l);
+    DEBUG("int {} unsigned {} float {}", i, u, f);
+    INFO("cstr {} char {} bool {}", cs, c, b);
+    NOTICE("string {} pointer {} double {}", s, p, d);
+    WARNING("int64 {} int {} string {} cstr {}", l, i, s, cs);
+    ERROR("double {} float {} unsigned {} char {}", d, f, u, c);
+    CRITICAL("all {} {} {} {} {} {} {} {} {}", i, u, l, d, f, b, c, cs, s);
+    net.info(LOG_SRC, "direct {} {}", i, s);
+    db.warning(LOG_SRC, "direct {} {} {}", d, cs, p);
+}
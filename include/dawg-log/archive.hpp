@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "level.hpp"
+
+namespace DawgLog {
+    /**
+     * @brief On-disk layout of the indexed log archive
+     *
+     * An archive file starts with the 8-byte `kArchiveFileMagic` and is followed by
+     * self-describing blocks. Every block is laid out as:
+     *
+     * - the fixed `ArchiveBlockHeader` fields
+     * - a `kArchiveBloomBytes` bloom filter over the tokens of all lines in the block
+     * - `tag_count` 32-bit tag IDs (see archive_tag_id())
+     * - `payload_size` bytes of records
+     *
+     * Each record is `int64 time_ms, uint8 level, uint32 tag_id, uint16 tag_len,
+     * uint32 line_len` followed by the tag and the formatted line. All integers are
+     * stored in host byte order; readers never assume any alignment.
+     */
+    inline constexpr char kArchiveFileMagic[8] = {'D', 'A', 'W', 'G', 'A', 'R', 'C', '1'};
+    inline constexpr std::uint32_t kArchiveBlockMagic = 0x314b4c42; // "BLK1"
+    inline constexpr std::size_t kArchiveBlockHeaderBytes = 40;
+    inline constexpr std::size_t kArchiveBloomBytes = 2048;
+    inline constexpr std::size_t kArchiveRecordPrefix = 8 + 1 + 4 + 2 + 4;
+
+    struct ArchiveBlockHeader {
+        std::uint32_t magic{kArchiveBlockMagic};
+        std::uint32_t records{0};
+        std::uint64_t payload_size{0};
+        std::int64_t min_ms{0};
+        std::int64_t max_ms{0};
+        std::uint32_t level_mask{0};
+        std::uint32_t tag_count{0};
+    };
+
+    /**
+     * @brief Stable archive tag ID (32-bit FNV-1a of the tag name)
+     */
+    std::uint32_t archive_tag_id(std::string_view tag);
+
+    /**
+     * @brief Bit of a level inside ArchiveBlockHeader::level_mask
+     */
+    inline std::uint32_t archive_level_bit(LogLevel level) {
+        return 1u << static_cast<unsigned>(level);
+    }
+
+    /**
+     * @brief Split text into the word tokens indexed by the block bloom filter
+     *
+     * Tokens are maximal runs of ASCII letters, digits and underscores.
+     */
+    void archive_tokenize(std::string_view text, const std::function<void(std::string_view)> &fn);
+
+    /** Add a token to a `kArchiveBloomBytes` bloom filter */
+    void archive_bloom_add(std::uint8_t *bloom, std::string_view token);
+
+    /** Check whether a token may be present in a `kArchiveBloomBytes` bloom filter */
+    bool archive_bloom_may_contain(const std::uint8_t *bloom, std::string_view token);
+
+    /**
+     * @brief Tokens that any line containing `query` must contain as whole tokens
+     *
+     * For a substring search only the tokens fully enclosed by non-word characters
+     * inside the query are guaranteed to be whole tokens of a matching line; with
+     * `whole_words` every token of the query is required.
+     */
+    std::vector<std::string> archive_required_tokens(std::string_view query, bool whole_words);
+
+    /** One decoded archive record; views point into the mapped file */
+    struct ArchiveRecord {
+        std::int64_t time_ms{0};
+        LogLevel level{LogLevel::info};
+        std::uint32_t tag_id{0};
+        std::string_view tag;
+        std::string_view line;
+    };
+
+    /** One block of a mapped archive; pointers refer to the mapped file */
+    struct ArchiveBlock {
+        ArchiveBlockHeader header;
+        const std::uint8_t *bloom{nullptr};
+        const std::uint8_t *tag_ids{nullptr};
+        const char *payload{nullptr};
+
+        [[nodiscard]] bool has_tag(std::uint32_t id) const;
+
+        /**
+         * @brief Decode every record of the block in order
+         * @return false if the payload is truncated or corrupt
+         */
+        bool for_each_record(const std::function<void(const ArchiveRecord &)> &fn) const;
+    };
+
+    /**
+     * @brief Read-only memory-mapped view of an archive file
+     *
+     * The block list is built once when the file is opened; a truncated trailing
+     * block (e.g. from a process still writing) is ignored.
+     */
+    class ArchiveReader {
+    public:
+        explicit ArchiveReader(const std::string &path);
+        ~ArchiveReader();
+
+        ArchiveReader(const ArchiveReader &) = delete;
+        ArchiveReader &operator=(const ArchiveReader &) = delete;
+
+        [[nodiscard]] bool is_open() const { return data_ != nullptr; }
+        [[nodiscard]] const std::vector<ArchiveBlock> &blocks() const { return blocks_; }
+
+    private:
+        const char *data_{nullptr};
+        std::size_t size_{0};
+        std::vector<ArchiveBlock> blocks_;
+    };
+} // namespace DawgLog
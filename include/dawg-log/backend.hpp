@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace DawgLog {
+    /**
+     * @brief Placement, scheduling and idle behaviour of background writer threads
+     *
+     * Applied to the writer thread of every target queue and to the background
+     * threads of the network and compressed file sinks. On hosts with isolated
+     * cores, pin the writers to housekeeping cores with `cpus` so they never run on a
+     * latency-critical one.
+     */
+    struct BackendOptions {
+        enum class SchedPolicy {
+            OTHER,
+            BATCH,
+            IDLE,
+            FIFO,
+            RR
+        };
+
+        /**
+         * How an idle writer waits for records. SPIN and SPIN_YIELD give the lowest
+         * wake-up latency and burn a core; CONDVAR sleeps in the kernel and is woken by
+         * producers; SLEEP polls at `sleep_interval` and never costs producers a wake-up.
+         */
+        enum class Wait {
+            SPIN,
+            SPIN_YIELD,
+            CONDVAR,
+            SLEEP
+        };
+
+        /** CPUs the thread may run on; empty keeps the inherited affinity */
+        std::vector<int> cpus;
+
+        SchedPolicy policy{SchedPolicy::OTHER};
+
+        /** Real-time priority for FIFO and RR */
+        int priority{0};
+
+        /** Thread niceness, applied with setpriority() to the thread only */
+        std::optional<int> nice;
+
+        Wait wait{Wait::CONDVAR};
+
+        /** Polling interval of Wait::SLEEP */
+        std::chrono::microseconds sleep_interval{100};
+
+        /** Busy iterations before SPIN_YIELD starts yielding */
+        unsigned spin_iterations{1000};
+    };
+
+    /**
+     * @brief Apply affinity, scheduling policy and niceness to the calling thread
+     *
+     * Failures (e.g. missing CAP_SYS_NICE for real-time policies) are reported on
+     * stderr and leave the thread as it was.
+     *
+     * @param options Options to apply
+     */
+    void apply_backend_options(const BackendOptions &options);
+
+    /** @return Policy for a name (`other`, `batch`, `idle`, `fifo`, `rr`), OTHER for unknown names */
+    BackendOptions::SchedPolicy string_to_sched_policy(const std::string &name);
+
+    /** @return Wait strategy for a name (`spin`, `spin_yield`, `condvar`, `sleep`), CONDVAR for unknown names */
+    BackendOptions::Wait string_to_wait(const std::string &name);
+} // namespace DawgLog
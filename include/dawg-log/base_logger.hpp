@@ -1,17 +1,27 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 #include <fmt/core.h>
 #include "config.hpp"
+#include "flight_recorder.hpp"
 #include "sinks/sink.hpp"
 #include "formatters/formatter.hpp"
 #include "record.hpp"
 #include "src_location.hpp"
+#include "tag_registry.hpp"
+#include "target_filter.hpp"
+#include "target_queue.hpp"
 
 namespace DawgLog {
+   class LogBatch;
+
    /**
     * @brief Main logging class responsible for managing log output and formatting
     *
@@ -29,6 +39,10 @@ namespace DawgLog {
     struct Target {
         SinkPtr sink;
         FormatterPtr formatter;
+        /** Optional own writer thread; when set, the sink is only written from it */
+        std::unique_ptr<TargetQueue> queue;
+        /** Records this target writes; checked before the formatter runs */
+        TargetFilter filter;
     };
     /**
      * @brief Construct a new Logger instance
@@ -56,7 +70,7 @@ namespace DawgLog {
      *
      * @tparam Args Template parameters for variadic arguments
      * @param lvl The severity level of this log message
-     * @param tag Optional tag for categorizing the log message
+     * @param tag Interned tag for categorizing the log message
      * @param src Source location information where the log was generated
      * @param fmt_str Format string using fmt library syntax
      * @param args Arguments to be formatted into the message
@@ -64,25 +78,262 @@ namespace DawgLog {
      * @return formatted string (the message)
      */
     template<typename... Args>
-    std::string log(LogLevel lvl, std::string_view tag, const SourceLocation &src,
+    std::string log(LogLevel lvl, const Tag &tag, const SourceLocation &src,
              fmt::string_view fmt_str, Args &&... args) {
+#ifdef DAWGLOG_INLINE_LOG
+        if (!enabled(lvl, tag.id)) {
+            if (recorder_) {
+                recorder_->capture(lvl, tag, src, fmt_str, args...);
+            }
+            return {};
+        }
         std::lock_guard<std::mutex> lock(m_);
-        std::string msg;
-    #if FMT_VERSION >= 80000
-                 msg = fmt::format(fmt::runtime(fmt_str), std::forward<Args>(args)...);
-    #else
-        msg = fmt::format(fmt_str, std::forward<Args>(args)...);
-    #endif
+        std::string msg = format_message(fmt_str, std::forward<Args>(args)...);
         auto rec = Record{lvl, tag, src, this->app_name_, msg};
-        for (auto &target : targets_) {
-            if (!target.sink || !target.formatter) {
-                continue;
-            }
-            target.sink->write(rec, target.formatter->format(rec));
+        if (recorder_ && lvl >= recorder_->options().dump_level) {
+            write_flight_recorder_locked();
         }
+        write_locked(rec);
         return msg;
+#else
+        if (!enabled(lvl, tag.id) && !recorder_) {
+            return {};
+        }
+        return vlog(lvl, tag, src, fmt_str, fmt::make_format_args(args...));
+#endif
+    }
+
+    /**
+     * @brief Type-erased log(): the single out-of-line logging path
+     *
+     * log() only packs its arguments into fmt::format_args and calls this function,
+     * so a call site instantiates no locking, formatting or target code. Define
+     * DAWGLOG_INLINE_LOG to inline the whole path into every log() instead (kept for
+     * the `dawglog_size_report` comparison).
+     *
+     * @param lvl The severity level of this log message
+     * @param tag Interned tag for categorizing the log message
+     * @param src Source location information where the log was generated
+     * @param fmt_str Format string using fmt library syntax
+     * @param args Type-erased arguments; only valid during the call
+     *
+     * @return formatted string (the message), empty if the record was suppressed
+     */
+    std::string vlog(LogLevel lvl, const Tag &tag, const SourceLocation &src,
+                     fmt::string_view fmt_str, fmt::format_args args);
+
+    /**
+     * @brief Log a message with a large body that is written without copies
+     *
+     * The payload is borrowed for the duration of the call and passed as
+     * Record::payload. The formatter writes the header (the formatted message) and
+     * sinks that support it write the payload right after the header: the file and
+     * console sinks with the same write call, syslog split into several messages,
+     * journald as a PAYLOAD field. Queued targets copy the payload once into the queue.
+     * Payload records are not kept by the flight recorder.
+     *
+     * Usage example: `logger.log_payload(LogLevel::info, tag, LOG_SRC, body, "POST {} {}", path, status)`
+     *
+     * @param lvl The severity level of this log message
+     * @param tag Interned tag for categorizing the log message
+     * @param src Source location information where the log was generated
+     * @param payload The body, only read during the call
+     * @param fmt_str Format string of the header message
+     * @param args Arguments to be formatted into the message
+     */
+    template<typename... Args>
+    void log_payload(LogLevel lvl, const Tag &tag, const SourceLocation &src, std::string_view payload,
+                     fmt::string_view fmt_str, Args &&... args) {
+        if (enabled(lvl, tag.id)) {
+            vlog_payload(lvl, tag, src, payload, fmt_str, fmt::make_format_args(args...));
+        }
+    }
+
+    /** @brief Type-erased log_payload() */
+    void vlog_payload(LogLevel lvl, const Tag &tag, const SourceLocation &src, std::string_view payload,
+                      fmt::string_view fmt_str, fmt::format_args args);
+
+    /**
+     * @brief Log a message with a tag given by name
+     *
+     * Interns the tag on every call; prefer TaggedLogger or the Tag overload on hot paths.
+     */
+    template<typename... Args>
+    std::string log(LogLevel lvl, std::string_view tag, const SourceLocation &src,
+             fmt::string_view fmt_str, Args &&... args) {
+        return log(lvl, TagRegistry::intern(tag), src, fmt_str, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Format a message with the same rules used by log()
+     *
+     * @param fmt_str Format string using fmt library syntax
+     * @param args Arguments to be formatted into the message
+     * @return std::string The formatted message
+     */
+    template<typename... Args>
+    static std::string format_message(fmt::string_view fmt_str, Args &&... args) {
+    #if FMT_VERSION >= 80000
+        return fmt::format(fmt::runtime(fmt_str), std::forward<Args>(args)...);
+    #else
+        return fmt::format(fmt_str, std::forward<Args>(args)...);
+    #endif
+    }
+
+    /**
+     * @brief Check whether records of a level pass the active level
+     *
+     * @param lvl The level to check
+     * @return true if records of this level are written to the targets
+     */
+    [[nodiscard]] bool enabled(LogLevel lvl) const {
+        return lvl >= level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Check whether records of a level and tag pass the active level
+     *
+     * A level override of the tag (see set_tag_level()) takes precedence over the
+     * logger level.
+     *
+     * @param lvl The level to check
+     * @param tag ID of the record tag
+     * @return true if records of this level and tag are written to the targets
+     */
+    [[nodiscard]] bool enabled(LogLevel lvl, TagId tag) const {
+        return lvl >= level_for(tag);
     }
 
+    /**
+     * @brief Resolve the minimum level for records of a tag
+     * @param tag ID of the record tag
+     * @return LogLevel The tag level override, or the logger level
+     */
+    [[nodiscard]] LogLevel level_for(TagId tag) const {
+        const auto override_level = TagRegistry::level(tag);
+        return override_level ? *override_level : level();
+    }
+
+    /**
+     * @brief Check whether a log call at this level has any effect
+     *
+     * Unlike enabled(), this is also true for suppressed levels while the flight
+     * recorder is capturing them. The logging macros use it to decide whether the
+     * call arguments are evaluated at all.
+     *
+     * @param lvl The level to check
+     * @return true if a log call at this level is written or captured
+     */
+    [[nodiscard]] bool should_log(LogLevel lvl) const {
+        return recorder_ != nullptr || enabled(lvl);
+    }
+
+    /** @copydoc should_log(LogLevel) const */
+    [[nodiscard]] bool should_log(LogLevel lvl, TagId tag) const {
+        return recorder_ != nullptr || enabled(lvl, tag);
+    }
+
+    /** @return true if suppressed records are kept by the flight recorder */
+    [[nodiscard]] bool is_recording() const { return recorder_ != nullptr; }
+
+    /**
+     * @brief Current configuration epoch
+     *
+     * The epoch changes whenever the global logger is replaced or a setting that
+     * handles may cache (levels, targets) changes. TaggedLogger compares it on every
+     * call to decide whether its cached state is still valid.
+     *
+     * @return std::uint64_t Epoch counter, never 0
+     */
+    static std::uint64_t config_epoch() { return epoch_.load(std::memory_order_acquire); }
+
+    /** @return The minimum level written to the targets */
+    [[nodiscard]] LogLevel level() const { return level_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Change the minimum level written to the targets
+     *
+     * Records below this level are dropped, or kept by the flight recorder when it
+     * is enabled. This operation is thread-safe.
+     *
+     * @param lvl New minimum level
+     */
+    void set_level(LogLevel lvl) {
+        level_.store(lvl, std::memory_order_relaxed);
+        bump_epoch();
+    }
+
+    /**
+     * @brief Set or clear the level override of a tag
+     *
+     * @param tag The tag name
+     * @param lvl Minimum level for records of this tag, or std::nullopt to follow
+     *            the logger level
+     */
+    void set_tag_level(std::string_view tag, std::optional<LogLevel> lvl);
+
+    /**
+     * @brief Write an already built record to the targets
+     *
+     * Skips the level checks but applies the target filters. Used to forward records
+     * produced elsewhere, e.g. by dawglog-agent.
+     *
+     * @param rec The record to write
+     */
+    void write(const Record &rec);
+
+    /**
+     * @brief Write already built records to the targets under one lock
+     *
+     * Each target formats the records in one pass and receives them with a single
+     * Sink::write_batch() (or TargetQueue::push_batch()). Like write(), skips the
+     * level checks but applies the target filters. A record at or above the flight
+     * recorder dump level dumps the recorder before the batch is written.
+     *
+     * @param records The records, in order
+     */
+    void write_batch(std::span<const Record> records);
+
+    /**
+     * @brief Write the record of a finished timing span (see ScopedSpan)
+     *
+     * The record carries the span name as its message, ends at `end_ns` (its mono_ns)
+     * and has `span_ns` set. Spans are not kept by the flight recorder.
+     *
+     * @param lvl Level of the record
+     * @param tag Tag of the record
+     * @param src Source location where the span was opened
+     * @param name Span name
+     * @param start_ns Monotonic clock when the span started
+     * @param end_ns Monotonic clock when the span ended
+     */
+    void span(LogLevel lvl, const Tag &tag, const SourceLocation &src, std::string_view name,
+              std::uint64_t start_ns, std::uint64_t end_ns);
+
+    /**
+     * @brief Start a batch of records for a hot loop
+     *
+     * @param tag Tag of the records of the batch
+     * @return LogBatch Collects records and writes them on commit()
+     */
+    LogBatch batch(const Tag &tag);
+
+    /** @brief Start a batch of records with the general tag */
+    LogBatch batch();
+
+    /** @return The memory budget shared by the target queues, or null */
+    [[nodiscard]] const std::shared_ptr<MemoryBudget> &memory_budget() const { return budget_; }
+
+    /** @return Application name written into each record */
+    [[nodiscard]] const std::string &app_name() const { return app_name_; }
+
+    /**
+     * @brief Write the records kept by the flight recorder to the targets now
+     *
+     * Does nothing when the flight recorder is disabled.
+     */
+    void flush_flight_recorder();
+
     /**
      * @brief Initialize the global logger instance with configuration
      *
@@ -176,9 +427,31 @@ namespace DawgLog {
      */
     void add_target(SinkPtr sink, FormatterPtr formatter);
 
+    /**
+     * @brief Wait until every target queue wrote its records to its sink
+     *
+     * Targets without a queue are written synchronously, so they need no flush.
+     */
+    void flush();
+
    private:
+    static void bump_epoch() { epoch_.fetch_add(1, std::memory_order_acq_rel); }
+
+    void apply_config(const Config &cfg);
+    void write_locked(const Record &rec);
+    void write_message_locked(LogLevel lvl, const Tag &tag, const SourceLocation &src, std::string_view msg,
+                              std::string_view payload);
+    void write_batch_locked(std::span<const Record> records);
+    void write_flight_recorder_locked();
+    void report_shedding_locked();
+
     std::vector<Target> targets_;
     std::mutex m_;
     std::string app_name_;
+    std::atomic<LogLevel> level_{LogLevel::debug};
+    std::unique_ptr<FlightRecorder> recorder_;
+    /** Budget of the target queues, if any; its shedding reports are logged periodically */
+    std::shared_ptr<MemoryBudget> budget_;
+    inline static std::atomic<std::uint64_t> epoch_{1};
    };
 } // namespace DawgLog
@@ -0,0 +1,139 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <fmt/format.h>
+
+namespace DawgLog {
+    /** Text encodings of binary data */
+    enum class BytesFormat {
+        /** Lower-case hex digits, two per byte */
+        HEX,
+        /** Upper-case hex digits, two per byte */
+        HEX_UPPER,
+        /** hexdump -C style lines: offset, 16 bytes in hex, the printable characters */
+        DUMP,
+        /** Standard base64 with padding */
+        BASE64
+    };
+
+    /**
+     * @brief Binary data log argument
+     *
+     * Formats as hex by default. The format spec selects the encoding and caps the
+     * number of bytes rendered: `{:x}` / `{:X}` hex, `{:d}` hex+ASCII dump, `{:b}` base64,
+     * and a precision (`{:.32}`, `{:.32d}`) renders only the first bytes followed by
+     * `... (<size> bytes)`. The encoders use SSSE3/AVX2 where the CPU has them.
+     *
+     * The message is formatted once, before the target formatters run, so the encoding
+     * does not follow the target format: JSON targets get base64 only with `{:b}`.
+     *
+     * Usage example:
+     * ```cpp
+     * TAG_DEBUG(net, "packet {:.64}", DawgLog::bytes(packet));
+     * ```
+     */
+    struct Bytes {
+        std::span<const std::byte> data;
+    };
+
+    /** @brief Wrap raw memory into a Bytes log argument */
+    inline Bytes bytes(const void *data, std::size_t size) {
+        return Bytes{std::span<const std::byte>(static_cast<const std::byte *>(data), size)};
+    }
+
+    /** @brief Wrap a contiguous range of trivially copyable elements (vector, array, span, string) */
+    template<std::ranges::contiguous_range R>
+        requires std::is_trivially_copyable_v<std::ranges::range_value_t<R>>
+    Bytes bytes(const R &range) {
+        return Bytes{std::as_bytes(std::span(std::ranges::data(range), std::ranges::size(range)))};
+    }
+
+    /**
+     * @brief Number of characters encode_bytes() writes
+     * @param format The encoding
+     * @param size Number of input bytes
+     */
+    std::size_t encoded_size(BytesFormat format, std::size_t size);
+
+    /**
+     * @brief Encode binary data as text
+     * @param format The encoding
+     * @param in The data
+     * @param out Destination with room for encoded_size() characters
+     * @return char* End of the written characters
+     */
+    char *encode_bytes(BytesFormat format, std::span<const std::byte> in, char *out);
+
+    /**
+     * @brief Append the encoding of binary data to a fmt output
+     *
+     * Encodes in stack-sized chunks and appends each chunk to the fmt buffer at once.
+     *
+     * @param out Output of a fmt format context
+     * @param format The encoding
+     * @param in The data
+     * @return fmt::appender End of the output
+     */
+    fmt::appender format_bytes(fmt::appender out, BytesFormat format, std::span<const std::byte> in);
+} // namespace DawgLog
+
+template<>
+struct fmt::formatter<DawgLog::Bytes> {
+    DawgLog::BytesFormat format_{DawgLog::BytesFormat::HEX};
+    std::size_t limit_{std::numeric_limits<std::size_t>::max()};
+
+    constexpr auto parse(format_parse_context &ctx) -> decltype(ctx.begin()) {
+        auto it = ctx.begin();
+        if (it != ctx.end() && *it == '.') {
+            limit_ = 0;
+            while (++it != ctx.end() && *it >= '0' && *it <= '9') {
+                limit_ = limit_ * 10 + static_cast<std::size_t>(*it - '0');
+            }
+        }
+        if (it != ctx.end() && *it != '}') {
+            switch (*it++) {
+                case 'x':
+                    format_ = DawgLog::BytesFormat::HEX;
+                    break;
+                case 'X':
+                    format_ = DawgLog::BytesFormat::HEX_UPPER;
+                    break;
+                case 'd':
+                    format_ = DawgLog::BytesFormat::DUMP;
+                    break;
+                case 'b':
+                    format_ = DawgLog::BytesFormat::BASE64;
+                    break;
+                default:
+                    throw format_error("invalid format for DawgLog::Bytes, expected x, X, d or b");
+            }
+        }
+        if (it != ctx.end() && *it != '}') {
+            throw format_error("invalid format for DawgLog::Bytes");
+        }
+        return it;
+    }
+
+    template<typename FormatContext>
+    auto format(const DawgLog::Bytes &value, FormatContext &ctx) const -> decltype(ctx.out()) {
+        const auto data = value.data.first(std::min(limit_, value.data.size()));
+        auto out = ctx.out();
+        if constexpr (std::is_same_v<decltype(out), fmt::appender>) {
+            out = DawgLog::format_bytes(out, format_, data);
+        } else {
+            // Contexts with their own output iterator
+            std::string text(DawgLog::encoded_size(format_, data.size()), '\0');
+            DawgLog::encode_bytes(format_, data, text.data());
+            out = std::copy(text.begin(), text.end(), out);
+        }
+        if (data.size() < value.data.size()) {
+            out = fmt::format_to(out, "... ({} bytes)", value.data.size());
+        }
+        return out;
+    }
+};
@@ -6,6 +6,8 @@
 
 #include <exception>
 #include <concepts>
+#include <string>
+#include <string_view>
 #include <type_traits>
 
 namespace DawgLog {
@@ -13,4 +15,18 @@ namespace DawgLog {
 template <typename E>
 concept ExceptionType = std::is_base_of_v<std::exception, E>;
 
+struct Record;
+
+/** A sink usable in a StaticTarget: anything with write(const Record&, std::string_view) */
+template <typename S>
+concept StaticSinkType = requires(S &sink, const Record &rec, std::string_view formatted) {
+    sink.write(rec, formatted);
+};
+
+/** A formatter usable in a StaticTarget: anything with format(const Record&) returning a string */
+template <typename F>
+concept StaticFormatterType = requires(F &formatter, const Record &rec) {
+    { formatter.format(rec) } -> std::convertible_to<std::string>;
+};
+
 }
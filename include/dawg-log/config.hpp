@@ -1,10 +1,17 @@
 #pragma once
+#include "backend.hpp"
+#include "memory_budget.hpp"
 #include "sinks/sink.hpp"
 #include "formatters/formatter.hpp"
+#include "target_filter.hpp"
+#include "target_queue.hpp"
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <optional>
 #include <vector>
 #include <nlohmann/json.hpp>
 
@@ -29,7 +36,53 @@ namespace DawgLog {
         struct TargetConfig {
             SinkType sink{SinkType::CONSOLE};
             FormatterType format{FormatterType::TEXT};
+            /** Add thread ID/name, CPU and monotonic time to `text` and `json` output */
+            bool thread_fields{false};
             std::string file_path{"dawglog.log"};
+            /** Uncompressed frame size for the `compressed_file` sink */
+            std::size_t frame_bytes{1 << 20};
+            /** Payload size of an index block for the `archive` sink */
+            std::size_t block_bytes{64 * 1024};
+            /** Collector address and transport for the `network` sink */
+            std::string host{"127.0.0.1"};
+            std::uint16_t port{514};
+            std::string protocol{"tcp"};
+            /** TCP framing: `newline` or `octet_counting` (RFC 6587) */
+            std::string framing{"newline"};
+            /** On-disk spool for the `network` sink while the collector is down */
+            std::string spool_path;
+            std::size_t spool_max_bytes{64 << 20};
+            /** Records per system call, UDP datagram packing and in-memory queue of the `network` sink */
+            std::size_t max_batch{256};
+            bool udp_batch{false};
+            std::size_t send_queue_bytes{4 << 20};
+            /** Shared-memory segment read by dawglog-agent for the `shm` sink */
+            std::string shm_name{"/dawglog"};
+            std::size_t shm_slots{8192};
+            std::size_t shm_slot_bytes{1024};
+            /** Buffer of each per-thread shard of the `sharded_file` sink (path prefix: file_path) */
+            std::size_t shard_buffer_bytes{64 * 1024};
+            /** Native protocol socket of systemd-journald for the `journald` sink */
+            std::string journal_socket{"/run/systemd/journal/socket"};
+            /** Longest message of the `syslog` sink; longer record payloads are split */
+            std::size_t syslog_max_bytes{8192};
+            /**
+             * Own queue and writer thread for this target, e.g.
+             * `"queue": {"capacity": 8192, "max_bytes": 8388608, "overflow": "drop_oldest"}`
+             */
+            std::optional<TargetQueue::Options> queue;
+            /**
+             * Records written by this target: `min_level`, `include_tags`, `exclude_tags`,
+             * `include_sources` and `exclude_sources` (wildcard patterns on the source file)
+             */
+            TargetFilter::Options filter;
+        };
+
+        struct FlightRecorderConfig {
+            bool enabled{false};
+            std::size_t capacity{256};
+            LogLevel dump_level{LogLevel::error};
+            bool all_threads{false};
         };
         /**
          * @brief Logger sink type enumeration
@@ -56,8 +109,60 @@ namespace DawgLog {
          */
         std::string app_name;
         std::string file_path;
+
+        /**
+         * @brief Options of the top-level sink, used when there is no `targets` array
+         *
+         * The sink options of a target (`frame_bytes`, `block_bytes`, `host`, `port`,
+         * `protocol`, `framing`, `spool_*`, `shm_*`, `shard_buffer_bytes`, `journal_socket`,
+         * `syslog_max_bytes`, `thread_fields`) may also be set at the top level. The sink,
+         * format and file path of this entry are taken from the fields above.
+         */
+        TargetConfig sink_options;
         std::vector<TargetConfig> targets;
 
+        /**
+         * @brief Minimum level written to the targets
+         *
+         * Records below this level are dropped (or kept by the flight recorder).
+         * Defaults to debug, i.e. everything is written.
+         */
+        LogLevel level{LogLevel::debug};
+
+        /**
+         * @brief Per-tag level overrides, e.g. `"tag_levels": {"net": "debug"}`
+         *
+         * A tag listed here uses its own minimum level instead of `level`.
+         */
+        std::map<std::string, LogLevel> tag_levels;
+
+        /**
+         * @brief Flight recorder settings
+         *
+         * Enabled by a `flight_recorder` object in the JSON file, e.g.
+         * `{"capacity": 256, "dump_level": "error", "scope": "thread"}`; `scope` may
+         * also be `all` to dump the records of every thread.
+         */
+        FlightRecorderConfig flight_recorder;
+
+        /**
+         * @brief Writer thread settings of all target queues
+         *
+         * From a `backend` object, e.g. `{"cpus": [0, 1], "policy": "batch", "nice": 10,
+         * "wait": "spin_yield"}`. `wait` is one of `spin`, `spin_yield`, `condvar` (default)
+         * or `sleep` (with `sleep_us`).
+         */
+        BackendOptions backend;
+
+        /**
+         * @brief Global byte budget of all target queues
+         *
+         * From a `memory_budget` object, e.g. `{"max_bytes": 67108864, "reserve_bytes":
+         * 8388608, "report_interval_ms": 10000}`; `shed_debug`, `shed_info` and
+         * `shed_notice` set the fill levels at which those levels are dropped.
+         */
+        std::optional<MemoryBudget::Options> memory_budget;
+
         /**
          * @brief Construct a Config object from JSON file
          *
@@ -90,6 +195,41 @@ namespace DawgLog {
                 return path.lexically_normal().string();
             };
 
+            const auto read_strings = [](const nlohmann::json &j, const char *key) {
+                std::vector<std::string> values;
+                if (j.contains(key) && j[key].is_array()) {
+                    for (const auto &value : j[key]) {
+                        if (value.is_string()) {
+                            values.push_back(value.get<std::string>());
+                        }
+                    }
+                }
+                return values;
+            };
+
+            const auto read_sink_options = [&resolve_path](const nlohmann::json &j, TargetConfig &cfg) {
+                cfg.thread_fields = j.value("thread_fields", cfg.thread_fields);
+                cfg.frame_bytes = j.value("frame_bytes", cfg.frame_bytes);
+                cfg.block_bytes = j.value("block_bytes", cfg.block_bytes);
+                cfg.host = j.value("host", cfg.host);
+                cfg.port = j.value("port", cfg.port);
+                cfg.protocol = j.value("protocol", cfg.protocol);
+                cfg.framing = j.value("framing", cfg.framing);
+                if (j.contains("spool_path")) {
+                    cfg.spool_path = resolve_path(j.value("spool_path", ""));
+                }
+                cfg.spool_max_bytes = j.value("spool_max_bytes", cfg.spool_max_bytes);
+                cfg.max_batch = j.value("max_batch", cfg.max_batch);
+                cfg.udp_batch = j.value("udp_batch", cfg.udp_batch);
+                cfg.send_queue_bytes = j.value("send_queue_bytes", cfg.send_queue_bytes);
+                cfg.shm_name = j.value("shm_name", cfg.shm_name);
+                cfg.shm_slots = j.value("shm_slots", cfg.shm_slots);
+                cfg.shm_slot_bytes = j.value("shm_slot_bytes", cfg.shm_slot_bytes);
+                cfg.shard_buffer_bytes = j.value("shard_buffer_bytes", cfg.shard_buffer_bytes);
+                cfg.journal_socket = j.value("journal_socket", cfg.journal_socket);
+                cfg.syslog_max_bytes = j.value("syslog_max_bytes", cfg.syslog_max_bytes);
+            };
+
             std::ifstream file(json_path);
             if (!file.is_open()) {
                 std::cerr << "Failed to open logger config file: " << json_path << std::endl;
@@ -109,6 +249,50 @@ namespace DawgLog {
             format = string_to_formatter_type(j.value("format", "text"));
             app_name = j.value("app_name", "DawgLog");
             file_path = resolve_path(j.value("file_path", "dawglog.log"));
+            level = string_to_level(j.value("level", "debug"), LogLevel::debug);
+            read_sink_options(j, sink_options);
+
+            if (j.contains("tag_levels") && j["tag_levels"].is_object()) {
+                for (const auto &[tag, lvl] : j["tag_levels"].items()) {
+                    if (lvl.is_string()) {
+                        tag_levels[tag] = string_to_level(lvl.get<std::string>(), level);
+                    }
+                }
+            }
+
+            if (j.contains("flight_recorder") && j["flight_recorder"].is_object()) {
+                const auto &fr = j["flight_recorder"];
+                flight_recorder.enabled = fr.value("enabled", true);
+                flight_recorder.capacity = fr.value("capacity", flight_recorder.capacity);
+                flight_recorder.dump_level = string_to_level(fr.value("dump_level", "error"), LogLevel::error);
+                flight_recorder.all_threads = fr.value("scope", "thread") == "all";
+            }
+
+            if (j.contains("backend") && j["backend"].is_object()) {
+                const auto &b = j["backend"];
+                backend.cpus = b.value("cpus", backend.cpus);
+                backend.policy = string_to_sched_policy(b.value("policy", "other"));
+                backend.priority = b.value("priority", backend.priority);
+                if (b.contains("nice") && b["nice"].is_number_integer()) {
+                    backend.nice = b["nice"].get<int>();
+                }
+                backend.wait = string_to_wait(b.value("wait", "condvar"));
+                backend.sleep_interval = std::chrono::microseconds(b.value("sleep_us", backend.sleep_interval.count()));
+                backend.spin_iterations = b.value("spin_iterations", backend.spin_iterations);
+            }
+
+            if (j.contains("memory_budget") && j["memory_budget"].is_object()) {
+                const auto &m = j["memory_budget"];
+                MemoryBudget::Options budget;
+                budget.max_bytes = m.value("max_bytes", budget.max_bytes);
+                budget.reserve_bytes = m.value("reserve_bytes", budget.reserve_bytes);
+                budget.shed_debug = m.value("shed_debug", budget.shed_debug);
+                budget.shed_info = m.value("shed_info", budget.shed_info);
+                budget.shed_notice = m.value("shed_notice", budget.shed_notice);
+                budget.report_interval = std::chrono::milliseconds(
+                    m.value("report_interval_ms", budget.report_interval.count()));
+                memory_budget = budget;
+            }
 
             if (j.contains("targets") && j["targets"].is_array()) {
                 for (const auto &target : j["targets"]) {
@@ -119,6 +303,21 @@ namespace DawgLog {
                     cfg.sink = string_to_sink_type(target.value("sink", "console"));
                     cfg.format = string_to_formatter_type(target.value("format", "text"));
                     cfg.file_path = resolve_path(target.value("file_path", "dawglog.log"));
+                    read_sink_options(target, cfg);
+                    if (target.contains("queue") && target["queue"].is_object()) {
+                        const auto &q = target["queue"];
+                        TargetQueue::Options queue;
+                        queue.capacity = q.value("capacity", queue.capacity);
+                        queue.max_bytes = q.value("max_bytes", queue.max_bytes);
+                        queue.overflow = string_to_overflow(q.value("overflow", "drop_newest"));
+                        queue.format_workers = q.value("format_workers", queue.format_workers);
+                        cfg.queue = queue;
+                    }
+                    cfg.filter.min_level = string_to_level(target.value("min_level", "debug"), LogLevel::debug);
+                    cfg.filter.include_tags = read_strings(target, "include_tags");
+                    cfg.filter.exclude_tags = read_strings(target, "exclude_tags");
+                    cfg.filter.include_sources = read_strings(target, "include_sources");
+                    cfg.filter.exclude_sources = read_strings(target, "exclude_sources");
                     targets.emplace_back(std::move(cfg));
                 }
             }
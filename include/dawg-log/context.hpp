@@ -0,0 +1,115 @@
+#pragma once
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <fmt/format.h>
+
+namespace DawgLog {
+    /** A key/value pair of the diagnostic context, created with kv() */
+    struct ContextField {
+        enum class Kind {
+            STRING,
+            NUMBER,
+            BOOL
+        };
+
+        std::string key;
+        std::string value;
+        Kind kind{Kind::STRING};
+    };
+
+    /**
+     * @brief Create a context field
+     *
+     * The value is formatted once, here. Arithmetic values stay numbers in JSON output.
+     *
+     * @param key Field name
+     * @param value Any value fmt can format
+     * @return ContextField The field
+     */
+    template<typename T>
+    ContextField kv(std::string_view key, const T &value) {
+        using D = std::decay_t<T>;
+        auto kind = ContextField::Kind::STRING;
+        if constexpr (std::is_same_v<D, bool>) {
+            kind = ContextField::Kind::BOOL;
+        } else if constexpr (std::is_arithmetic_v<D> && !std::is_same_v<D, char>) {
+            kind = ContextField::Kind::NUMBER;
+        }
+        return ContextField{std::string(key), fmt::format("{}", value), kind};
+    }
+
+    /**
+     * @brief Immutable set of context fields, serialized once when it is created
+     *
+     * A frame contains its own fields merged with those of the enclosing frame (inner
+     * keys replace outer ones). Its text (`req=42 user=bob`) and JSON
+     * (`{"req":42,"user":"bob"}`) forms are built on construction, and formatters
+     * append them to every record logged inside the scope without formatting again.
+     */
+    class ContextFrame {
+    public:
+        ContextFrame(std::shared_ptr<const ContextFrame> parent, std::vector<ContextField> fields);
+
+        /** @return Merged fields of this frame and its parents */
+        [[nodiscard]] const std::vector<ContextField> &fields() const { return fields_; }
+
+        /** @return Fields as space-separated `key=value` pairs */
+        [[nodiscard]] const std::string &text() const { return text_; }
+
+        /** @return Fields as a JSON object */
+        [[nodiscard]] const std::string &json() const { return json_; }
+
+    private:
+        std::vector<ContextField> fields_;
+        std::string text_;
+        std::string json_;
+    };
+
+    /** Shared handle to a context frame; null means no context */
+    using ContextPtr = std::shared_ptr<const ContextFrame>;
+
+    /**
+     * @brief Get the context of the calling thread
+     *
+     * Pass the result to ScopedContext on another thread (a pool task, a resumed
+     * coroutine) to log with the same context there.
+     *
+     * @return ContextPtr The current frame, or null
+     */
+    ContextPtr current_context();
+
+    /**
+     * @brief RAII scope that adds fields to the calling thread's diagnostic context
+     *
+     * Usage example:
+     * ```cpp
+     * DawgLog::ScopedContext ctx{DawgLog::kv("req", id), DawgLog::kv("user", name)};
+     * auto captured = DawgLog::current_context();
+     * pool.post([captured] {
+     *     DawgLog::ScopedContext restore{captured};
+     *     INFO("still tagged with req and user");
+     * });
+     * ```
+     */
+    class ScopedContext {
+    public:
+        /** Enter a scope with additional fields */
+        ScopedContext(std::initializer_list<ContextField> fields);
+
+        /** Install a captured context for the lifetime of the scope */
+        explicit ScopedContext(ContextPtr captured);
+
+        /** Restore the context that was active before the scope */
+        ~ScopedContext();
+
+        ScopedContext(const ScopedContext &) = delete;
+        ScopedContext &operator=(const ScopedContext &) = delete;
+
+    private:
+        ContextPtr previous_;
+    };
+} // namespace DawgLog
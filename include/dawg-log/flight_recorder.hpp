@@ -0,0 +1,141 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fmt/core.h>
+#include "record.hpp"
+
+namespace DawgLog {
+    /**
+     * @brief Bounded per-thread ring of records suppressed by the active log level
+     *
+     * The flight recorder keeps the last `capacity` records below the active level of
+     * every thread without formatting them: the format string and the raw values of
+     * arithmetic, character, pointer and string arguments are copied into reusable
+     * slot buffers. Messages with any other argument type are formatted at capture
+     * time instead. When a record at or above the dump level is logged, the ring of
+     * that thread (or of every thread) is formatted and handed to the logger targets.
+     */
+    class FlightRecorder {
+    public:
+        struct Options {
+            /** Number of records kept per thread */
+            std::size_t capacity{256};
+
+            /** Records at or above this level dump the recorder */
+            LogLevel dump_level{LogLevel::error};
+
+            /** Dump the rings of all threads instead of only the logging thread */
+            bool all_threads{false};
+        };
+
+        explicit FlightRecorder(Options options);
+
+        [[nodiscard]] const Options &options() const { return options_; }
+
+        /**
+         * @brief Store a suppressed record in the calling thread's ring
+         *
+         * @param lvl The level of the suppressed record
+         * @param tag The record tag
+         * @param src Source location of the log call
+         * @param fmt_str Format string of the message
+         * @param args Arguments to format into the message when dumped
+         */
+        template<typename... Args>
+        void capture(LogLevel lvl, const Tag &tag, const SourceLocation &src,
+                     fmt::string_view fmt_str, const Args &... args) {
+            vcapture(lvl, tag, src, fmt_str, fmt::make_format_args(args...));
+        }
+
+        /**
+         * @brief Type-erased capture() shared by all argument types
+         *
+         * @param lvl The level of the suppressed record
+         * @param tag The record tag
+         * @param src Source location of the log call
+         * @param fmt_str Format string of the message
+         * @param args Type-erased arguments; only valid during the call
+         */
+        void vcapture(LogLevel lvl, const Tag &tag, const SourceLocation &src,
+                      fmt::string_view fmt_str, fmt::format_args args);
+
+        /**
+         * @brief Format and remove the recorded records selected by the dump scope
+         *
+         * @param app_name Application name stored in the produced records
+         * @return std::vector<Record> Records ordered by capture time
+         */
+        std::vector<Record> drain(std::string_view app_name);
+
+    private:
+        static constexpr std::size_t kMaxArgs = 8;
+
+        enum class ArgKind : std::uint8_t { I64, U64, F32, F64, BOOL, CHAR, PTR, STR };
+
+        struct Arg {
+            ArgKind kind{ArgKind::I64};
+            union {
+                std::int64_t i;
+                std::uint64_t u;
+                float f;
+                double d;
+                bool b;
+                char c;
+                const void *p;
+                std::size_t offset;
+            };
+            std::size_t size{0};
+        };
+
+        struct Slot {
+            LogLevel level{LogLevel::debug};
+            SourceLocation src;
+            std::chrono::system_clock::time_point time;
+            std::uint64_t mono_ns{0};
+            int cpu{-1};
+            ContextPtr context;
+            Tag tag;
+            std::string fmt;
+            std::string text;
+            std::array<Arg, kMaxArgs> args{};
+            std::size_t nargs{0};
+            bool preformatted{false};
+        };
+
+        struct Ring {
+            explicit Ring(std::size_t capacity) : slots(capacity), thread(current_thread()) {}
+
+            Slot &claim() {
+                Slot &slot = slots[next];
+                next = (next + 1) % slots.size();
+                count = count < slots.size() ? count + 1 : count;
+                return slot;
+            }
+
+            std::mutex m;
+            std::vector<Slot> slots;
+            std::size_t next{0};
+            std::size_t count{0};
+            ThreadInfo thread;
+        };
+
+        struct ArgStore;
+
+        static std::string render(const Slot &slot);
+
+        Ring &local_ring();
+
+        Options options_;
+        std::uint64_t generation_;
+        std::mutex rings_m_;
+        std::vector<std::weak_ptr<Ring>> rings_;
+    };
+} // namespace DawgLog
@@ -36,6 +36,26 @@ namespace DawgLog {
          * @return std::string Formatted string representation of the log record
          */
         virtual std::string format(const Record &r) = 0;
+
+        /**
+         * @brief Create an independent copy of this formatter
+         *
+         * Copies let several threads format records of the same target at once (see
+         * TargetQueue::Options::format_workers). Formatters that cannot be copied keep
+         * this default, and their records are formatted by the logging thread.
+         *
+         * @return std::unique_ptr<Formatter> The copy, or nullptr if the formatter cannot be copied
+         */
+        [[nodiscard]] virtual std::unique_ptr<Formatter> clone() const { return nullptr; }
+
+        /**
+         * @brief Whether format() already accounts for Record::payload
+         *
+         * The default formats a header only and the payload is written right after it.
+         * Formatters that must escape the payload (JSON) embed it and return true, as do
+         * formatters that deliberately leave it out.
+         */
+        [[nodiscard]] virtual bool embeds_payload() const { return false; }
     };
 
     /**
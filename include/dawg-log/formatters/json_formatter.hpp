@@ -10,6 +10,9 @@ namespace DawgLog {
      * - Timestamp information
      * - Log level
      * - Message content
+     * - Thread ID and name, CPU and monotonic time (`tid`, `thread`, `cpu`, `mono_ns`),
+     *   when constructed with `thread_fields`
+     * - Duration of timing spans (`span_ns`)
      * - Any additional fields or metadata from the record
      *
      * The formatted output follows a consistent JSON structure suitable for machine processing
@@ -17,6 +20,15 @@ namespace DawgLog {
      */
     class JsonFormatter : public Formatter {
     public:
+        /**
+         * @brief Construct a JSON formatter
+         *
+         * @param thread_fields Add the thread, CPU and monotonic time of the record:
+         *                      `tid`, `thread`, `cpu`, `mono_ns`
+         */
+        explicit JsonFormatter(bool thread_fields = false) : thread_fields_(thread_fields) {
+        }
+
         /**
          * @brief Format a log record as a JSON string
          *
@@ -27,5 +39,12 @@ namespace DawgLog {
          * @return std::string JSON formatted string representing the log record
          */
         std::string format(const Record &r) override;
+
+        [[nodiscard]] std::unique_ptr<Formatter> clone() const override { return std::make_unique<JsonFormatter>(*this); }
+
+        [[nodiscard]] bool embeds_payload() const override { return true; }
+
+    private:
+        bool thread_fields_;
     };
 } // namespace DawgLog
@@ -4,6 +4,15 @@
 namespace DawgLog {
     class TextFormatter : public Formatter {
     public:
+        /**
+         * @brief Construct a text formatter
+         *
+         * @param thread_fields Append the thread, CPU and monotonic time of the record:
+         *                      ", THREAD: TID(NAME) CPU: N MONO: NS"
+         */
+        explicit TextFormatter(bool thread_fields = false) : thread_fields_(thread_fields) {
+        }
+
         /**
          * @brief Formats a log record into a text-based string representation
          *
@@ -13,6 +22,7 @@ namespace DawgLog {
          *
          * The formatted output follows this pattern:
          * "APP_NAME TIMESTAMP [TAG] LEVEL: MESSAGE, SOURCE: FILE:LINE"
+         * Inside a ScopedContext, " {KEY=VALUE ...}" follows the message.
          *
          * Example output: "MyApp 14:30:45 [ERROR] ERROR: Database connection failed, SOURCE: main.cpp:42"
          *
@@ -20,5 +30,10 @@ namespace DawgLog {
          * @return std::string Formatted text string representation of the log record
          */
         std::string format(const Record &r) override;
+
+        [[nodiscard]] std::unique_ptr<Formatter> clone() const override { return std::make_unique<TextFormatter>(*this); }
+
+    private:
+        bool thread_fields_;
     };
 } // namespace DawgLog
@@ -0,0 +1,32 @@
+#pragma once
+#include "formatter.hpp"
+
+namespace DawgLog {
+    /**
+     * @brief Formats records as Chrome Trace Event JSON objects
+     *
+     * Timing spans (records with `span_ns`) become complete events (`"ph": "X"`) with
+     * `ts` and `dur` in microseconds of the monotonic clock; other records become
+     * thread-scoped instant events (`"ph": "i"`). The tag is the event category, and the
+     * level, source location, message and context go into `args`. The events can be
+     * loaded into Perfetto or chrome://tracing, e.g. through TraceFileSink.
+     */
+    class TraceEventFormatter : public Formatter {
+    public:
+        TraceEventFormatter();
+
+        /**
+         * @brief Format a record as one trace event object (without separator)
+         * @param r The log record to format
+         * @return std::string JSON object of the event
+         */
+        std::string format(const Record &r) override;
+
+        [[nodiscard]] std::unique_ptr<Formatter> clone() const override { return std::make_unique<TraceEventFormatter>(*this); }
+
+        [[nodiscard]] bool embeds_payload() const override { return true; }
+
+    private:
+        int pid_;
+    };
+} // namespace DawgLog
@@ -4,8 +4,17 @@
 #include <fmt/core.h>
 #include "base_logger.hpp"
 #include "concepts.hpp"
+#include "bytes.hpp"
+#include "lazy.hpp"
+#include "log_site.hpp"
 
 namespace DawgLog {
+   /** @brief Interned tag used by the general (untagged) log functions */
+   inline const Tag &general_tag() {
+       static const Tag tag = TagRegistry::intern("General");
+       return tag;
+   }
+
    /**
     * @brief Log a message with general tag for all type of logs
     * @tparam Args Variadic template parameters for formatting arguments
@@ -16,42 +25,71 @@ namespace DawgLog {
 #define X(name, general, str, syslog) \
     template <typename... Args> \
     static void name(const SourceLocation& src, fmt::string_view fmt_str, Args&&... args) { \
-        Logger::instance().log(LogLevel::name, "General", src, fmt_str, std::forward<Args>(args)...); \
+        Logger::instance().log(LogLevel::name, general_tag(), src, fmt_str, std::forward<Args>(args)...); \
     }
         LOG_LEVELS_XMACRO
 #undef X
 
     template<ExceptionType E, typename... Args>
     static void throw_error(const SourceLocation& src, fmt::string_view fmt_str, Args&&... args) {
-        auto error_msg = Logger::instance().log(LogLevel::error, "General", src, fmt_str, std::forward<Args>(args)...);
+        auto& logger = Logger::instance();
+        if (!logger.enabled(LogLevel::error, general_tag().id)) {
+            logger.flush_flight_recorder();
+            throw E{Logger::format_message(fmt_str, std::forward<Args>(args)...)};
+        }
+        auto error_msg = logger.log(LogLevel::error, general_tag(), src, fmt_str, std::forward<Args>(args)...);
         throw E{error_msg};
     }
 
-#define DEBUG(...) debug(LOG_SRC, __VA_ARGS__)
+   /**
+    * @brief Run a log call only if its level is active and its call site is enabled
+    *
+    * The level and the per-site flag are checked before `call` is evaluated, so the
+    * arguments of a filtered-out record (e.g. `expensive_dump(obj)`) are never computed.
+    */
+#define DAWGLOG_LOG_IF(active, call) \
+    do { \
+        static constinit ::DawgLog::LogSite dawglog_site_{__FILE__, __LINE__}; \
+        if ((active) && dawglog_site_.enabled()) { \
+            call; \
+        } \
+    } while (0)
+
+#define DAWGLOG_GENERAL_LOG(lvl, ...) \
+    DAWGLOG_LOG_IF(::DawgLog::Logger::instance().should_log(::DawgLog::LogLevel::lvl, ::DawgLog::general_tag().id), \
+                   ::DawgLog::lvl(LOG_SRC, __VA_ARGS__))
+
+#define DAWGLOG_TAG_LOG(logger, lvl, ...) \
+    do { \
+        auto &&dawglog_logger_ = (logger); \
+        DAWGLOG_LOG_IF(dawglog_logger_.should_log(::DawgLog::LogLevel::lvl), dawglog_logger_.lvl(LOG_SRC, __VA_ARGS__)); \
+    } while (0)
+
+#define DEBUG(...) DAWGLOG_GENERAL_LOG(debug, __VA_ARGS__)
 
-#define INFO(...) info(LOG_SRC, __VA_ARGS__)
+#define INFO(...) DAWGLOG_GENERAL_LOG(info, __VA_ARGS__)
 
-#define NOTICE(...) notice(LOG_SRC, __VA_ARGS__)
+#define NOTICE(...) DAWGLOG_GENERAL_LOG(notice, __VA_ARGS__)
 
-#define WARNING(...) warning(LOG_SRC, __VA_ARGS__)
+#define WARNING(...) DAWGLOG_GENERAL_LOG(warning, __VA_ARGS__)
 
-#define ERROR(...) error(LOG_SRC, __VA_ARGS__)
+#define ERROR(...) DAWGLOG_GENERAL_LOG(error, __VA_ARGS__)
 
-#define CRITICAL(...) critical(LOG_SRC, __VA_ARGS__)
+#define CRITICAL(...) DAWGLOG_GENERAL_LOG(critical, __VA_ARGS__)
 
 #define THROW_ERROR(...) throw_error<std::runtime_error>(LOG_SRC, __VA_ARGS__)
 
-#define TAG_DEBUG(logger, ...) (logger).debug(LOG_SRC, __VA_ARGS__)
+#define TAG_DEBUG(logger, ...) DAWGLOG_TAG_LOG(logger, debug, __VA_ARGS__)
 
-#define TAG_INFO(logger, ...) (logger).info(LOG_SRC, __VA_ARGS__)
+#define TAG_INFO(logger, ...) DAWGLOG_TAG_LOG(logger, info, __VA_ARGS__)
 
-#define TAG_NOTICE(logger, ...) (logger).notice(LOG_SRC, __VA_ARGS__)
+#define TAG_NOTICE(logger, ...) DAWGLOG_TAG_LOG(logger, notice, __VA_ARGS__)
 
-#define TAG_WARNING(logger, ...) (logger).warning(LOG_SRC, __VA_ARGS__)
+#define TAG_WARNING(logger, ...) DAWGLOG_TAG_LOG(logger, warning, __VA_ARGS__)
 
-#define TAG_ERROR(logger, ...) (logger).error(LOG_SRC, __VA_ARGS__)
+#define TAG_ERROR(logger, ...) DAWGLOG_TAG_LOG(logger, error, __VA_ARGS__)
 
-#define TAG_CRITICAL(logger, ...) (logger).critical(LOG_SRC, __VA_ARGS__)
+#define TAG_CRITICAL(logger, ...) DAWGLOG_TAG_LOG(logger, critical, __VA_ARGS__)
 
 #define TAG_THROW_ERROR(logger, ...) (logger).throw_error<std::runtime_error>(LOG_SRC, __VA_ARGS__)
 
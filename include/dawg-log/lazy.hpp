@@ -0,0 +1,42 @@
+#pragma once
+#include <type_traits>
+#include <utility>
+#include <fmt/format.h>
+
+namespace DawgLog {
+    /**
+     * @brief Log argument that is computed only while the message is formatted
+     *
+     * The logging macros already skip evaluating their arguments when a record is
+     * filtered out. Lazy covers the remaining cases, e.g. calling a log method
+     * directly: the callable runs only if the message is actually formatted.
+     * Records captured by the flight recorder are formatted at capture time, so the
+     * callable also runs for those.
+     *
+     * Usage example:
+     * ```cpp
+     * logger.debug(LOG_SRC, "state: {}", DawgLog::lazy([&] { return dump(state); }));
+     * ```
+     */
+    template<typename F>
+    struct Lazy {
+        F fn;
+    };
+
+    /**
+     * @brief Wrap a callable into a Lazy log argument
+     * @param fn Callable whose result is formatted in place of the argument
+     */
+    template<typename F>
+    Lazy<std::decay_t<F>> lazy(F &&fn) {
+        return Lazy<std::decay_t<F>>{std::forward<F>(fn)};
+    }
+} // namespace DawgLog
+
+template<typename F>
+struct fmt::formatter<DawgLog::Lazy<F>> : fmt::formatter<std::decay_t<std::invoke_result_t<const F &>>> {
+    template<typename FormatContext>
+    auto format(const DawgLog::Lazy<F> &value, FormatContext &ctx) const -> decltype(ctx.out()) {
+        return fmt::formatter<std::decay_t<std::invoke_result_t<const F &>>>::format(value.fn(), ctx);
+    }
+};
@@ -1,4 +1,6 @@
 #pragma once
+#include <string>
+#include <string_view>
 #include <syslog.h>
 
 namespace DawgLog {
@@ -70,4 +72,25 @@ X(critical, CRITICAL, "CRITICAL", LOG_CRIT)
         }
         return LOG_INFO; // Default fallback
     }
+
+    /**
+     * @brief Parse a log level from its enum name or its string representation
+     *
+     * Accepts both the lowercase enum names ("warning") and the strings returned by
+     * to_string() ("WARN").
+     *
+     * @param name The level name to parse
+     * @param out Receives the parsed level on success
+     * @return bool true if the name was recognized
+     */
+    inline bool parse_level(std::string_view name, LogLevel &out) {
+#define X(lvl, general, str, syslog) \
+        if (name == #lvl || name == str) { \
+            out = LogLevel::lvl; \
+            return true; \
+        }
+        LOG_LEVELS_XMACRO
+#undef X
+        return false;
+    }
 } // namespace DawgLog
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <fmt/core.h>
+#include "base_logger.hpp"
+#include "general_logs.hpp"
+#include "record.hpp"
+#include "src_location.hpp"
+#include "tag_registry.hpp"
+
+namespace DawgLog {
+    /**
+     * @brief Collects records and writes them to the logger targets in one go
+     *
+     * Each call formats the message and builds the record (time, thread, context) right
+     * away, but keeps it in a buffer of the calling thread. commit() then takes the
+     * logger lock once, runs each target formatter over the whole batch and hands it to
+     * the sink with a single Sink::write_batch() (one writev/sendmmsg where the sink
+     * supports it). Records are committed automatically when `auto_commit` records are
+     * pending and when the batch goes out of scope.
+     *
+     * Level checks and the flight recorder work as for Logger::log().
+     *
+     * Usage example:
+     * ```cpp
+     * auto b = DawgLog::Logger::instance().batch(DawgLog::TagRegistry::intern("etl"));
+     * for (const auto& row : rows) {
+     *     b.info(LOG_SRC, "row {} loaded ({} bytes)", row.id, row.size);
+     * }
+     * b.commit();
+     * ```
+     */
+    class LogBatch {
+    public:
+        /** Default number of pending records that triggers a commit */
+        static constexpr std::size_t kDefaultAutoCommit = 4096;
+
+        /**
+         * @brief Start a batch
+         * @param logger Logger receiving the records
+         * @param tag Tag of all records of the batch
+         * @param auto_commit Commit when this many records are pending; 0 disables it
+         */
+        LogBatch(Logger &logger, const Tag &tag, std::size_t auto_commit = kDefaultAutoCommit);
+
+        /** Commit the pending records */
+        ~LogBatch();
+
+        LogBatch(LogBatch &&other) noexcept;
+        LogBatch &operator=(LogBatch &&) = delete;
+        LogBatch(const LogBatch &) = delete;
+        LogBatch &operator=(const LogBatch &) = delete;
+
+        /**
+         * @brief Add a record at the specified level
+         * @param lvl The severity level of this log message
+         * @param src Source location information where the log was generated
+         * @param fmt_str Format string using fmt library syntax
+         * @param args Arguments to be formatted into the message
+         */
+        template<typename... Args>
+        void log(LogLevel lvl, const SourceLocation &src, fmt::string_view fmt_str, Args &&... args) {
+            if (!logger_->enabled(lvl, tag_.id) && !logger_->is_recording()) {
+                return;
+            }
+            vadd(lvl, src, fmt_str, fmt::make_format_args(args...));
+        }
+
+        /**
+         * @brief Add a record at a fixed level
+         * @tparam Args Variadic template parameters for formatting arguments
+         * @param src Source location information for the log call
+         * @param fmt_str Format string for the log message
+         * @param args Arguments to format into the message
+         */
+#define X(name, general, str, syslog) \
+    template <typename... Args> \
+    void name(const SourceLocation& src, fmt::string_view fmt_str, Args&&... args) { \
+        log(LogLevel::name, src, fmt_str, std::forward<Args>(args)...); \
+    }
+        LOG_LEVELS_XMACRO
+#undef X
+
+        /** Write the pending records to the targets */
+        void commit();
+
+        /** @return Number of records waiting for commit() */
+        [[nodiscard]] std::size_t pending() const { return records_.size(); }
+
+    private:
+        void vadd(LogLevel lvl, const SourceLocation &src, fmt::string_view fmt_str, fmt::format_args args);
+
+        Logger *logger_;
+        Tag tag_;
+        std::size_t auto_commit_;
+        std::vector<Record> records_;
+    };
+} // namespace DawgLog
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+namespace DawgLog {
+    /**
+     * @brief Per call-site state of the logging macros
+     *
+     * Every macro expansion owns a constant-initialized LogSite, so checking it costs
+     * one relaxed atomic load. A site registers itself on first use, which lets
+     * set_log_site_enabled() switch individual call sites (or whole files) off and on
+     * at runtime.
+     */
+    class LogSite {
+    public:
+        constexpr LogSite(const char *file, int line) : file_(file), line_(line) {
+        }
+
+        LogSite(const LogSite &) = delete;
+        LogSite &operator=(const LogSite &) = delete;
+
+        /** @return true unless the site was disabled with set_log_site_enabled() */
+        bool enabled() {
+            auto state = state_.load(std::memory_order_relaxed);
+            if (state == kUnregistered) {
+                state = register_site();
+            }
+            return state == kEnabled;
+        }
+
+        void set_enabled(bool enabled) {
+            state_.store(enabled ? kEnabled : kDisabled, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] const char *file() const { return file_; }
+        [[nodiscard]] int line() const { return line_; }
+
+    private:
+        static constexpr std::uint8_t kUnregistered = 0;
+        static constexpr std::uint8_t kEnabled = 1;
+        static constexpr std::uint8_t kDisabled = 2;
+
+        std::uint8_t register_site();
+
+        const char *file_;
+        int line_;
+        std::atomic<std::uint8_t> state_{kUnregistered};
+    };
+
+    /**
+     * @brief Enable or disable logging macro call sites
+     *
+     * The rule applies to sites that are already registered and to sites registered
+     * later. `file` matches the end of the site's `__FILE__` (e.g. "net/socket.cpp").
+     *
+     * @param file Source file suffix to match
+     * @param line Line of the call site, or 0 for every site in the file
+     * @param enabled Whether matching sites evaluate and emit their records
+     */
+    void set_log_site_enabled(std::string_view file, int line, bool enabled);
+} // namespace DawgLog
@@ -2,4 +2,7 @@
 
 #include "tagged_logger.hpp"
 #include "general_logs.hpp"
+#include "log_batch.hpp"
+#include "span.hpp"
+#include "static_logger.hpp"
 #include "config.hpp"
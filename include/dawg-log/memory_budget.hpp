@@ -0,0 +1,108 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "level.hpp"
+
+namespace DawgLog {
+    /** Number of LogLevel values */
+    inline constexpr std::size_t kLogLevelCount = 0
+#define X(name, general, str, syslog) + 1
+        LOG_LEVELS_XMACRO
+#undef X
+        ;
+
+    /**
+     * @brief Global byte budget shared by all target queues, shedding by level
+     *
+     * Every queued record takes its bytes from the budget until the writer thread has
+     * written it. The more of the budget is in use, the more levels are refused, lowest
+     * first: debug above `shed_debug` of `max_bytes`, info above `shed_info`, notice
+     * above `shed_notice` and warning above `max_bytes`. error and critical records are
+     * never refused: they additionally use `reserve_bytes`, an emergency area the other
+     * levels never touch, and once that is exhausted they overdraw the budget and are
+     * counted. The memory in use is therefore bounded by `max_bytes + reserve_bytes`
+     * plus the error and critical records queued beyond it.
+     *
+     * Only target queues are charged. The other buffers of the logger have fixed bounds
+     * of their own: the flight recorder (`capacity` records per thread), LogBatch (until
+     * it is flushed), the network sink (`send_queue_bytes`) and the compressed file sink
+     * (one `frame_bytes` frame).
+     *
+     * Refused and overdrawn records are counted per level. take_report() turns the
+     * counts into the text of a periodic synthetic record, so a log storm leaves a
+     * trace of what it cost.
+     */
+    class MemoryBudget {
+    public:
+        struct Options {
+            /** Bytes of queued records and formatted text for all levels */
+            std::size_t max_bytes{64 << 20};
+
+            /** Additional bytes only error and critical records may use */
+            std::size_t reserve_bytes{8 << 20};
+
+            /** Fractions of max_bytes above which debug, info and notice are shed */
+            double shed_debug{0.5};
+            double shed_info{0.7};
+            double shed_notice{0.85};
+
+            /** Minimum time between two shedding reports */
+            std::chrono::milliseconds report_interval{10000};
+        };
+
+        explicit MemoryBudget(Options options);
+
+        MemoryBudget(const MemoryBudget &) = delete;
+        MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+        /**
+         * @brief Take bytes for a record, or count it as shed
+         * @param lvl Level of the record
+         * @param bytes Bytes the record keeps buffered
+         * @return true if the record fits (always for error and critical); the caller must
+         *         release() the bytes later
+         */
+        bool try_acquire(LogLevel lvl, std::size_t bytes);
+
+        /** Return bytes taken by try_acquire() */
+        void release(std::size_t bytes);
+
+        /** @return Bytes currently in use */
+        [[nodiscard]] std::size_t used() const { return used_.load(std::memory_order_relaxed); }
+
+        /** @return Records of a level refused since the budget was created */
+        [[nodiscard]] std::uint64_t shed(LogLevel lvl) const;
+
+        /** @return error and critical records kept beyond the reserve since the budget was created */
+        [[nodiscard]] std::uint64_t overdrawn() const { return overdrawn_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Report the records shed since the previous report
+         *
+         * Not thread-safe; the logger calls it under its lock.
+         *
+         * @return Text such as `shed 1200 DEBUG, 85 INFO records (memory budget ...)`, or
+         *         std::nullopt if nothing was shed or overdrawn, or the report interval
+         *         has not passed
+         */
+        std::optional<std::string> take_report();
+
+        [[nodiscard]] const Options &options() const { return options_; }
+
+    private:
+        [[nodiscard]] std::size_t limit(LogLevel lvl) const;
+
+        Options options_;
+        std::atomic<std::size_t> used_{0};
+        std::array<std::atomic<std::uint64_t>, kLogLevelCount> shed_{};
+        std::array<std::uint64_t, kLogLevelCount> reported_{};
+        std::atomic<std::uint64_t> overdrawn_{0};
+        std::uint64_t reported_overdrawn_{0};
+        std::chrono::steady_clock::time_point last_report_{};
+    };
+} // namespace DawgLog
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+
+namespace DawgLog {
+    /**
+     * @brief Set the memory resource of the logger internals
+     *
+     * Records, the record arenas and the target queues allocate from this resource
+     * unless a queue has its own (TargetQueue::Options::memory_resource). Set it before
+     * logging starts; it must outlive every logger, queue and record.
+     *
+     * @param resource The resource, nullptr restores new/delete
+     */
+    void set_log_memory_resource(std::pmr::memory_resource *resource);
+
+    /** @return The memory resource of the logger internals */
+    std::pmr::memory_resource *log_memory_resource();
+
+    /**
+     * @brief Per-thread monotonic arena for the record being written
+     *
+     * Logger::log() builds its record in the arena of the calling thread and resets the
+     * arena once every target has consumed the record, so logging a record costs no
+     * heap allocation while it fits the inline buffer. Larger records take chunks from
+     * log_memory_resource(), which are returned on reset.
+     */
+    class RecordArena {
+    public:
+        /** Bytes served without touching the upstream resource */
+        static constexpr std::size_t kInlineBytes = 4096;
+
+        /** @return The arena of the calling thread */
+        static RecordArena &local();
+
+        RecordArena(const RecordArena &) = delete;
+        RecordArena &operator=(const RecordArena &) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource *resource() { return &arena_; }
+
+        /** Free everything allocated since the last reset; nothing allocated from it may be used afterwards */
+        void reset() { arena_.release(); }
+
+    private:
+        RecordArena();
+
+        alignas(std::max_align_t) std::byte buffer_[kInlineBytes];
+        std::pmr::monotonic_buffer_resource arena_;
+    };
+} // namespace DawgLog
@@ -1,7 +1,14 @@
 #pragma once
+#include <chrono>
+#include <memory_resource>
 #include <string>
 #include "level.hpp"
 #include "src_location.hpp"
+#include <cstdint>
+#include "context.hpp"
+#include "memory_resource.hpp"
+#include "tag_registry.hpp"
+#include "thread_info.hpp"
 #include "utils.hpp"
 
 namespace DawgLog {
@@ -16,45 +23,153 @@ namespace DawgLog {
      * - Thread ID for multithreaded applications
      *
      * Records are typically created by Logger instances and passed to Sinks for output.
+     * Their strings allocate from a memory resource, log_memory_resource() unless the
+     * constructor is given another one.
      */
     struct Record {
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
         /** Name of the application that generated this log record */
-        std::string app_name;
+        std::pmr::string app_name;
+
+        /** Wall-clock time point when the record was created */
+        std::chrono::system_clock::time_point time;
 
         /** formatted timestamp when the record was created */
-        std::string timestamp;
+        std::pmr::string timestamp;
 
         /** Log level indicating the severity of the message */
         LogLevel level{LogLevel::info};
 
-        /** Optional tag for categorizing log messages */
-        std::string tag;
+        /** ID of the interned tag */
+        TagId tag_id{0};
+
+        /** Optional tag for categorizing log messages; views the interned tag name */
+        std::string_view tag;
 
         /** The actual log message content */
-        std::string message;
+        std::pmr::string message;
 
         /** Source location information where the log was generated */
         SourceLocation src;
 
+        /** Kernel thread ID of the logging thread */
+        std::uint32_t thread_id{0};
+
+        /** Name of the logging thread, empty if unnamed */
+        std::pmr::string thread_name;
+
+        /** CPU the logging thread ran on, -1 if unknown */
+        int cpu{-1};
+
+        /** Monotonic clock at log time in nanoseconds; use it to measure gaps between records */
+        std::uint64_t mono_ns{0};
+
+        /** Diagnostic context (see ScopedContext) active when the record was created */
+        ContextPtr context;
+
+        /** Duration of a timing span (see ScopedSpan) that ended at mono_ns; 0 for other records */
+        std::uint64_t span_ns{0};
+
+        /**
+         * Large body borrowed from the caller of Logger::log_payload(), only valid while
+         * the record is being written. Formatters that do not embed it leave it to the
+         * sink, which writes it right after the formatted text (see Sink::writes_payload())
+         */
+        std::string_view payload;
+
         /**
          * @brief Construct a new Record instance
          *
          * Creates a log record with all necessary information. Automatically generates
-         * timestamp and thread ID, and initializes other fields from parameters.
+         * timestamp, thread ID and name, CPU and monotonic time, and initializes other
+         * fields from parameters.
+         *
+         * @param lvl The log level of this record
+         * @param tag Interned tag for categorizing the log message
+         * @param src Source location where the log was generated
+         * @param app_name Name of the application generating the log
+         * @param msg The actual log message content
+         * @param alloc Allocator of the record strings
+         */
+        Record(LogLevel lvl, const Tag &tag, const SourceLocation &src, std::string_view app_name,
+               std::string_view msg, allocator_type alloc = log_memory_resource())
+            : Record(lvl, tag, src, app_name, msg, std::chrono::system_clock::now(), alloc) {
+        }
+
+        /**
+         * @brief Construct a new Record instance, interning the tag
          *
          * @param lvl The log level of this record
          * @param tag Optional tag for categorizing the log message
          * @param src Source location where the log was generated
          * @param app_name Name of the application generating the log
          * @param msg The actual log message content
+         * @param alloc Allocator of the record strings
          */
         Record(LogLevel lvl, std::string_view tag, const SourceLocation &src, std::string_view app_name,
-               std::string_view msg) : app_name(app_name),
-                                       timestamp(make_timestamp()),
-                                       level(lvl),
-                                       tag(tag),
-                                       message(msg),
-                                       src(src) {
+               std::string_view msg, allocator_type alloc = log_memory_resource())
+            : Record(lvl, TagRegistry::intern(tag), src, app_name, msg, alloc) {
         }
+
+        /**
+         * @brief Construct a Record for a log call that happened at an earlier time
+         *
+         * @param lvl The log level of this record
+         * @param tag Optional tag for categorizing the log message
+         * @param src Source location where the log was generated
+         * @param app_name Name of the application generating the log
+         * @param msg The actual log message content
+         * @param time Wall-clock time of the original log call
+         * @param alloc Allocator of the record strings
+         */
+        Record(LogLevel lvl, const Tag &tag, const SourceLocation &src, std::string_view app_name,
+               std::string_view msg, std::chrono::system_clock::time_point time,
+               allocator_type alloc = log_memory_resource()) : app_name(app_name, alloc),
+                                                                time(time),
+                                                                timestamp(make_timestamp(time), alloc),
+                                                                level(lvl),
+                                                                tag_id(tag.id),
+                                                                tag(tag.name),
+                                                                message(msg, alloc),
+                                                                src(src),
+                                                                thread_name(alloc),
+                                                                cpu(current_cpu()),
+                                                                mono_ns(monotonic_ns()),
+                                                                context(current_context()) {
+            const auto &thread = current_thread();
+            thread_id = thread.id;
+            thread_name = thread.name;
+        }
+
+        /** Copies allocate from log_memory_resource(), not from the resource of the original */
+        Record(const Record &other) : Record(other, log_memory_resource()) {
+        }
+
+        /**
+         * @brief Copy a record into another memory resource
+         * @param other The record to copy
+         * @param alloc Allocator of the copy's strings
+         */
+        Record(const Record &other, allocator_type alloc) : app_name(other.app_name, alloc),
+                                                             time(other.time),
+                                                             timestamp(other.timestamp, alloc),
+                                                             level(other.level),
+                                                             tag_id(other.tag_id),
+                                                             tag(other.tag),
+                                                             message(other.message, alloc),
+                                                             src(other.src),
+                                                             thread_id(other.thread_id),
+                                                             thread_name(other.thread_name, alloc),
+                                                             cpu(other.cpu),
+                                                             mono_ns(other.mono_ns),
+                                                             context(other.context),
+                                                             span_ns(other.span_ns),
+                                                             payload(other.payload) {
+        }
+
+        Record(Record &&) noexcept = default;
+        Record &operator=(const Record &) = default;
+        Record &operator=(Record &&) = default;
     };
 } // namespace DawgLog
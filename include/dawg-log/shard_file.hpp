@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "level.hpp"
+
+namespace DawgLog {
+    /**
+     * @brief On-disk layout of the per-thread shard files written by ShardedFileSink
+     *
+     * A shard file starts with the 8-byte `kShardFileMagic`, the 32-bit shard number and
+     * the 32-bit PID of the writer. It is followed by records laid out as
+     * `uint32 text_len, uint8 level, uint64 seq, uint64 mono_ns, int64 time_ns` and the
+     * formatted text. `seq` counts the records of the shard from 0; `mono_ns` is the
+     * monotonic clock of the record (comparable between the shards of one host) and
+     * orders the merged stream. All integers are stored in host byte order.
+     */
+    inline constexpr char kShardFileMagic[8] = {'D', 'A', 'W', 'G', 'S', 'H', 'D', '1'};
+    inline constexpr std::size_t kShardFileHeaderBytes = 8 + 4 + 4;
+    inline constexpr std::size_t kShardRecordPrefix = 4 + 1 + 8 + 8 + 8;
+
+    /** One decoded shard record; `text` points into the mapped file */
+    struct ShardRecord {
+        std::uint64_t seq{0};
+        std::uint64_t mono_ns{0};
+        std::int64_t time_ns{0};
+        LogLevel level{LogLevel::info};
+        std::string_view text;
+    };
+
+    /**
+     * @brief Read-only memory-mapped view of a shard file
+     *
+     * A truncated trailing record (e.g. from a process killed while writing) ends
+     * the shard.
+     */
+    class ShardFileReader {
+    public:
+        explicit ShardFileReader(const std::string &path);
+        ~ShardFileReader();
+
+        ShardFileReader(const ShardFileReader &) = delete;
+        ShardFileReader &operator=(const ShardFileReader &) = delete;
+
+        [[nodiscard]] bool is_open() const { return data_ != nullptr; }
+
+        /** @return Shard number from the file header */
+        [[nodiscard]] std::uint32_t shard() const { return shard_; }
+
+        /** @return PID of the process that wrote the shard */
+        [[nodiscard]] std::uint32_t pid() const { return pid_; }
+
+        /**
+         * @brief Decode the next record
+         * @param out Receives the record
+         * @return false at the end of the shard
+         */
+        bool next(ShardRecord &out);
+
+    private:
+        const char *data_{nullptr};
+        std::size_t size_{0};
+        std::size_t pos_{0};
+        std::uint32_t shard_{0};
+        std::uint32_t pid_{0};
+    };
+} // namespace DawgLog
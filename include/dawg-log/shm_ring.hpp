@@ -0,0 +1,140 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "level.hpp"
+#include "record.hpp"
+
+namespace DawgLog {
+    /**
+     * Shared-memory record ring used by ShmSink (producer) and dawglog-agent (consumer)
+     *
+     * Segment layout: a ShmRingHeader followed by `slot_count` fixed-size slots. Each
+     * slot starts with a ShmSlotHeader and carries the tag, source file, thread name,
+     * message and payload bytes. Producers claim slots with a CAS on `enqueue_pos` and publish
+     * them by advancing the slot sequence (a bounded MPMC queue). The agent is the only
+     * consumer.
+     */
+    inline constexpr char kShmRingMagic[8] = {'D', 'A', 'W', 'G', 'S', 'H', 'M', '2'};
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "the shared-memory ring needs lock-free 64-bit atomics");
+
+    struct ShmRingHeader {
+        char magic[8];
+        std::uint32_t slot_count;
+        std::uint32_t slot_bytes;
+        std::int32_t producer_pid;
+        char app_name[64];
+        alignas(64) std::atomic<std::uint64_t> enqueue_pos;
+        alignas(64) std::atomic<std::uint64_t> dequeue_pos;
+        /** Records the producer dropped because the ring was full */
+        alignas(64) std::atomic<std::uint64_t> overruns;
+    };
+
+    struct ShmSlotHeader {
+        std::atomic<std::uint64_t> seq;
+        std::int64_t time_ns;
+        std::uint64_t mono_ns;
+        std::uint32_t thread_id;
+        std::int32_t cpu;
+        std::int32_t line;
+        std::uint8_t level;
+        /** Non-zero if the message or the payload was cut to fit the slot */
+        std::uint8_t truncated;
+        std::uint16_t tag_len;
+        std::uint16_t file_len;
+        std::uint16_t thread_name_len;
+        std::uint32_t message_len;
+        /** Bytes of the record payload (Logger::log_payload()) after the message */
+        std::uint32_t payload_len;
+    };
+
+    /** @return Size of a segment with the given geometry */
+    inline std::size_t shm_ring_bytes(std::size_t slot_count, std::size_t slot_bytes) {
+        return sizeof(ShmRingHeader) + slot_count * slot_bytes;
+    }
+
+    /** A record read from the ring; the views stay valid until the next ShmRingReader::next() */
+    struct ShmRecord {
+        LogLevel level{LogLevel::info};
+        std::int64_t time_ns{0};
+        std::uint64_t mono_ns{0};
+        std::uint32_t thread_id{0};
+        std::int32_t cpu{-1};
+        std::int32_t line{0};
+        bool truncated{false};
+        std::string_view tag;
+        std::string_view file;
+        std::string_view thread_name;
+        std::string_view message;
+        std::string_view payload;
+    };
+
+    /**
+     * @brief Turn a record read from the ring back into a Record
+     *
+     * The source file name is interned for the lifetime of the process, so the Record
+     * may outlive the ShmRecord (e.g. in a target queue). The payload still borrows from
+     * the reader buffer; Logger::write() copies it before returning. A truncated record
+     * gets ` [truncated]` appended to its message.
+     *
+     * @param in The record read with ShmRingReader::next()
+     * @param app_name Application name of the producer
+     */
+    Record to_record(const ShmRecord &in, std::string_view app_name);
+
+    /**
+     * @brief Consumer side of a shared-memory ring
+     *
+     * If the producer process dies between claiming and publishing a slot, the slot
+     * would block the ring forever. Once the producer PID is gone, next() skips such
+     * slots and counts them as torn.
+     */
+    class ShmRingReader {
+    public:
+        /**
+         * @brief Map an existing segment
+         * @param name POSIX shared-memory name, e.g. "/dawglog"
+         */
+        explicit ShmRingReader(const std::string &name);
+        ~ShmRingReader();
+
+        ShmRingReader(const ShmRingReader &) = delete;
+        ShmRingReader &operator=(const ShmRingReader &) = delete;
+
+        [[nodiscard]] bool is_open() const { return header_ != nullptr; }
+
+        /**
+         * @brief Take the next published record
+         * @param out Receives the record
+         * @return true if a record was read, false if the ring is empty
+         */
+        bool next(ShmRecord &out);
+
+        /** @return Records dropped by the producer because the ring was full */
+        [[nodiscard]] std::uint64_t overruns() const;
+
+        /** @return Slots skipped because the producer died while writing them */
+        [[nodiscard]] std::uint64_t torn() const { return torn_; }
+
+        /** @return true while the producer process exists */
+        [[nodiscard]] bool producer_alive() const;
+
+        /** @return true if the segment name now refers to a newer segment */
+        [[nodiscard]] bool replaced() const;
+
+        [[nodiscard]] std::string_view app_name() const;
+
+    private:
+        std::string name_;
+        ShmRingHeader *header_{nullptr};
+        std::size_t size_{0};
+        std::uint64_t inode_{0};
+        std::uint64_t torn_{0};
+        std::vector<char> buffer_;
+    };
+} // namespace DawgLog
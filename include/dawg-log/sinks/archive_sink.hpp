@@ -0,0 +1,57 @@
+#pragma once
+#include "sink.hpp"
+#include "../archive.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace DawgLog {
+    /**
+     * @brief Sink that writes records into the indexed archive format
+     *
+     * Formatted lines are collected into blocks of roughly `block_bytes`. Each block
+     * carries its time range, a level bitmap, the set of tag IDs and a bloom filter
+     * over the line tokens, which lets `dawglog-query` skip blocks without reading
+     * them. Records of the block being filled only reach the file when the block is
+     * full, on flush() or on destruction.
+     */
+    class ArchiveSink : public Sink {
+    public:
+        /** Default payload size of a block before it is written */
+        static constexpr std::size_t kDefaultBlockBytes = 64 * 1024;
+
+        /**
+         * @brief Open (or append to) an archive file
+         *
+         * @param path Path of the archive file
+         * @param block_bytes Payload bytes collected before a block is written
+         */
+        explicit ArchiveSink(std::string path, std::size_t block_bytes = kDefaultBlockBytes);
+
+        /** Write the pending block and close the file */
+        ~ArchiveSink() override;
+
+        void write(const Record &r, std::string_view formatted) override;
+
+        /** Write the pending block to disk */
+        void flush();
+
+    private:
+        void flush_locked();
+        void reset_block();
+
+        std::string path_;
+        std::size_t block_bytes_;
+        std::ofstream out_;
+
+        ArchiveBlockHeader header_;
+        std::array<std::uint8_t, kArchiveBloomBytes> bloom_{};
+        std::vector<std::uint32_t> tag_ids_;
+        std::string payload_;
+        std::mutex m_;
+    };
+} // namespace DawgLog
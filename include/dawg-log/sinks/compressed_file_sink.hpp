@@ -0,0 +1,121 @@
+#pragma once
+#include "sink.hpp"
+#include "../backend.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace DawgLog {
+    /**
+     * @brief File sink that compresses records inline into seekable gzip frames
+     *
+     * Records are appended to an in-memory frame. Once the frame reaches its size
+     * limit (or the flush interval expires) it is handed to a background thread that
+     * compresses it as an independent gzip member and appends it to the log file.
+     * Because every frame is a complete gzip member, the whole file can still be read
+     * with `zcat`, while the sidecar index (`<path>.idx`) allows a time range to be
+     * read by decompressing only the frames that overlap it.
+     *
+     * Each index line describes one frame:
+     * `offset compressed_size raw_size records first_ms last_ms`
+     */
+    class CompressedFileSink : public Sink {
+    public:
+        /** Default uncompressed size of a frame before it is sealed */
+        static constexpr std::size_t kDefaultFrameBytes = 1 << 20;
+
+        /** Describes one compressed frame inside the log file */
+        struct FrameIndexEntry {
+            std::uint64_t offset{0};
+            std::uint64_t compressed_size{0};
+            std::uint64_t raw_size{0};
+            std::uint64_t records{0};
+            std::int64_t first_ms{0};
+            std::int64_t last_ms{0};
+        };
+
+        /**
+         * @brief Open (or append to) a compressed log file
+         *
+         * @param path Path of the compressed log file; the index is written to `<path>.idx`
+         * @param frame_bytes Uncompressed bytes collected before a frame is sealed
+         * @param flush_interval Maximum time a non-empty frame stays in memory
+         * @param backend Placement and scheduling of the compressor thread; its wait strategy is not used
+         */
+        explicit CompressedFileSink(std::string path,
+                                    std::size_t frame_bytes = kDefaultFrameBytes,
+                                    std::chrono::milliseconds flush_interval = std::chrono::seconds(1),
+                                    BackendOptions backend = {});
+
+        /**
+         * @brief Seal the current frame, drain the compressor and close the file
+         */
+        ~CompressedFileSink() override;
+
+        void write(const Record &r, std::string_view formatted) override;
+
+        /**
+         * @brief Seal the current frame and wait until every frame is on disk
+         */
+        void flush();
+
+        /**
+         * @brief Read the frame index of a compressed log file
+         *
+         * @param path Path of the compressed log file (not the index itself)
+         * @return std::vector<FrameIndexEntry> Frames in file order
+         */
+        static std::vector<FrameIndexEntry> read_index(const std::string &path);
+
+        /**
+         * @brief Decompress only the frames overlapping a time range
+         *
+         * Frames are the unit of access, so the result may contain records slightly
+         * outside of [from, to] that share a frame with matching ones.
+         *
+         * @param path Path of the compressed log file
+         * @param from Start of the time range (inclusive)
+         * @param to End of the time range (inclusive)
+         * @return std::string Decompressed log lines of the overlapping frames
+         */
+        static std::string read_range(const std::string &path,
+                                      std::chrono::system_clock::time_point from,
+                                      std::chrono::system_clock::time_point to);
+
+    private:
+        struct Frame {
+            std::string data;
+            std::uint64_t records{0};
+            std::int64_t first_ms{0};
+            std::int64_t last_ms{0};
+        };
+
+        void seal_locked();
+        void run();
+        void write_frame(const Frame &frame);
+
+        std::string path_;
+        std::size_t frame_bytes_;
+        std::chrono::milliseconds flush_interval_;
+        BackendOptions backend_;
+        std::ofstream out_;
+        std::ofstream index_;
+        std::uint64_t offset_{0};
+
+        Frame active_;
+        std::deque<Frame> pending_;
+        bool busy_{false};
+        bool stop_{false};
+        std::mutex m_;
+        std::condition_variable work_cv_;
+        std::condition_variable idle_cv_;
+        std::thread worker_;
+    };
+} // namespace DawgLog
@@ -41,6 +41,15 @@ namespace DawgLog {
          */
         void write(const Record &r, std::string_view formatted) override;
 
+        /**
+         * @brief Write several records, flushing only when the output stream changes
+         *
+         * Keeps the order of records between stdout and stderr like write().
+         */
+        void write_batch(std::span<const SinkEntry> entries) override;
+
+        bool writes_payload() const override { return true; }
+
     private:
         std::string app_name;
         std::mutex m_;
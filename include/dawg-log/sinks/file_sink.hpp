@@ -16,6 +16,11 @@ namespace DawgLog {
 
         void write(const Record &r, std::string_view formatted) override;
 
+        /** Append all records and flush the stream once */
+        void write_batch(std::span<const SinkEntry> entries) override;
+
+        bool writes_payload() const override { return true; }
+
     private:
         std::string path_;
         std::ofstream out_;
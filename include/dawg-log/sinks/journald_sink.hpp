@@ -0,0 +1,52 @@
+#pragma once
+#include "sink.hpp"
+#include <string>
+#include <sys/uio.h>
+#include <vector>
+
+namespace DawgLog {
+    /**
+     * @brief Sink that writes records to systemd-journald with the native protocol
+     *
+     * Every record becomes one datagram of `FIELD=value` entries on the journal socket:
+     * MESSAGE, PRIORITY, CODE_FILE, CODE_LINE, CODE_FUNC, SYSLOG_IDENTIFIER, DAWGLOG_TAG,
+     * TID and the fields of the diagnostic context (upper-cased). Values containing a
+     * newline use the length-prefixed binary form. No formatter runs for this sink;
+     * the fields stay queryable with `journalctl DAWGLOG_TAG=net`.
+     *
+     * Records too large for a datagram are written to a sealed memfd, and the file
+     * descriptor is passed to journald instead. A record payload becomes the PAYLOAD
+     * field; payloads of 64 KiB and more go through the memfd directly.
+     */
+    class JournaldSink : public Sink {
+    public:
+        /**
+         * @brief Open a datagram socket for the journal
+         * @param identifier Value of SYSLOG_IDENTIFIER, usually the application name
+         * @param socket_path Path of the journal socket; tests point it at a stand-in
+         */
+        explicit JournaldSink(std::string identifier,
+                              std::string socket_path = "/run/systemd/journal/socket");
+        ~JournaldSink() override;
+
+        JournaldSink(const JournaldSink &) = delete;
+        JournaldSink &operator=(const JournaldSink &) = delete;
+
+        void write(const Record &r, std::string_view formatted) override;
+
+        /** Send one datagram per record with a single sendmmsg() */
+        void write_batch(std::span<const SinkEntry> entries) override;
+
+        bool needs_formatting() const override { return false; }
+
+        bool writes_payload() const override { return true; }
+
+    private:
+        bool send_datagram(const std::vector<iovec> &iov);
+        bool send_memfd(const std::vector<iovec> &iov);
+
+        std::string identifier_;
+        std::string socket_path_;
+        int fd_{-1};
+    };
+} // namespace DawgLog
@@ -0,0 +1,127 @@
+#pragma once
+#include "sink.hpp"
+#include "../backend.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace DawgLog {
+    /**
+     * @brief Sink that sends formatted records to a remote collector over UDP or TCP
+     *
+     * write() only queues the record; a background thread connects (non-blocking,
+     * with exponential reconnect backoff) and sends queued records in batches with a
+     * single `sendmsg`/`sendmmsg` call. TCP records are framed as in RFC 6587, either
+     * newline-terminated or octet-counted (`LEN SP MSG`).
+     *
+     * While the peer is unreachable, queued records are moved to a bounded on-disk
+     * spool (when `spool_path` is set). After reconnecting, the spool is replayed in
+     * order before any newer record is sent. When a send fails partway through a
+     * batch, only the records the peer did not receive completely are spooled; a
+     * record cut mid-frame is sent again whole on the next connection. Records that
+     * fit neither the queue nor the spool are dropped and counted.
+     */
+    class NetworkSink : public Sink {
+    public:
+        enum class Protocol {
+            UDP,
+            TCP
+        };
+
+        enum class Framing {
+            NEWLINE,
+            OCTET_COUNTING
+        };
+
+        struct Options {
+            std::string host{"127.0.0.1"};
+            std::uint16_t port{514};
+            Protocol protocol{Protocol::TCP};
+            Framing framing{Framing::NEWLINE};
+
+            /** UDP only: pack several newline-separated records into one datagram */
+            bool udp_batch{false};
+
+            /** Maximum number of records sent per system call */
+            std::size_t max_batch{256};
+
+            /** Bytes of formatted records kept in memory before new ones are dropped */
+            std::size_t queue_max_bytes{4 << 20};
+
+            /** Spool file used while the peer is down; empty disables spooling */
+            std::string spool_path;
+
+            /** Maximum size of the spool file */
+            std::size_t spool_max_bytes{64 << 20};
+
+            std::chrono::milliseconds connect_timeout{1000};
+            std::chrono::milliseconds send_timeout{1000};
+            std::chrono::milliseconds reconnect_min{100};
+            std::chrono::milliseconds reconnect_max{30000};
+
+            /** Placement and scheduling of the sender thread; its wait strategy is not used */
+            BackendOptions backend;
+        };
+
+        explicit NetworkSink(Options options);
+
+        /**
+         * @brief Send (or spool) the remaining records and stop the sender thread
+         */
+        ~NetworkSink() override;
+
+        void write(const Record &r, std::string_view formatted) override;
+
+        /** Queue all records under one lock and wake the background thread once */
+        void write_batch(std::span<const SinkEntry> entries) override;
+
+        /**
+         * @brief Wait until every queued record was sent or moved to the spool
+         */
+        void flush();
+
+        /** @return Number of records dropped because the queue or the spool was full */
+        [[nodiscard]] std::uint64_t dropped() const;
+
+        /** @return true while a connection to the peer is established */
+        [[nodiscard]] bool connected() const;
+
+    private:
+        void run();
+        bool ensure_connected();
+        void disconnect();
+        /** Schedule the next connection attempt with exponential backoff */
+        void reconnect_later();
+        /** @return Number of leading records of the batch that were sent completely */
+        std::size_t send_batch(const std::vector<std::string> &batch);
+        std::size_t send_stream(const std::vector<std::string> &batch);
+        std::size_t send_datagrams(const std::vector<std::string> &batch);
+        void spool(std::span<const std::string> records);
+        bool replay_spool();
+
+        Options options_;
+        int fd_{-1};
+        std::chrono::steady_clock::time_point next_attempt_{};
+        std::chrono::milliseconds backoff_;
+        std::uint64_t spool_read_offset_{0};
+        std::uint64_t spool_bytes_{0};
+
+        std::deque<std::string> queue_;
+        std::size_t queue_bytes_{0};
+        std::uint64_t dropped_{0};
+        bool in_flight_{false};
+        bool connected_{false};
+        bool stop_{false};
+        mutable std::mutex m_;
+        std::condition_variable work_cv_;
+        std::condition_variable idle_cv_;
+        std::thread worker_;
+    };
+} // namespace DawgLog
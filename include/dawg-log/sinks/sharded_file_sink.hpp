@@ -0,0 +1,64 @@
+#pragma once
+#include "sink.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace DawgLog {
+    /**
+     * @brief File sink with one file per writing thread
+     *
+     * Each thread that writes to the sink gets its own shard file,
+     * `<path>.<pid>.<shard>.shard`, and its own buffer. Threads never share a lock, a
+     * buffer or a file offset. A record costs a copy into the thread's buffer; the buffer
+     * is written when it reaches `buffer_bytes`, for records at or above `flush_level`,
+     * when the thread exits and on flush(). Records carry a per-shard sequence number,
+     * the monotonic clock and the wall-clock time (see shard_file.hpp).
+     *
+     * `dawglog-merge` combines the shards into one time-ordered stream.
+     */
+    class ShardedFileSink : public Sink {
+    public:
+        /**
+         * @brief Create a sink; shard files are created on first use by each thread
+         * @param path Path prefix of the shard files
+         * @param buffer_bytes Buffer size of each shard
+         * @param flush_level Records at or above this level are written immediately
+         */
+        explicit ShardedFileSink(std::string path, std::size_t buffer_bytes = 64 * 1024,
+                                 LogLevel flush_level = LogLevel::error);
+
+        /** Write the buffers of all shards and close them */
+        ~ShardedFileSink() override;
+
+        ShardedFileSink(const ShardedFileSink &) = delete;
+        ShardedFileSink &operator=(const ShardedFileSink &) = delete;
+
+        void write(const Record &r, std::string_view formatted) override;
+
+        void write_batch(std::span<const SinkEntry> entries) override;
+
+        /** Write the buffers of all shards to their files */
+        void flush();
+
+        /** @return Paths of the shard files created so far */
+        [[nodiscard]] std::vector<std::string> shard_paths() const;
+
+        struct Shard;
+
+    private:
+        Shard &local_shard();
+
+        std::string path_;
+        std::size_t buffer_bytes_;
+        LogLevel flush_level_;
+        /** Distinguishes sinks in the thread-local shard cache, never reused */
+        std::uint64_t id_;
+        /** Only locked when a thread creates its shard, and by flush() */
+        mutable std::mutex shards_m_;
+        std::vector<std::shared_ptr<Shard>> shards_;
+    };
+} // namespace DawgLog
@@ -0,0 +1,53 @@
+#pragma once
+#include "sink.hpp"
+#include "../shm_ring.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace DawgLog {
+    /**
+     * @brief Sink that hands raw records to dawglog-agent through shared memory
+     *
+     * write() copies the record fields into a slot of a lock-free ring in a POSIX
+     * shared-memory segment and returns; it performs no system call and never
+     * blocks. Formatting and file/syslog output happen in the dawglog-agent process,
+     * so this sink ignores the target formatter. When the ring is full the record is
+     * dropped and counted in the segment header, where the agent reports it.
+     *
+     * The segment is created fresh on construction and is not unlinked on
+     * destruction, so the agent can drain what is left after the application exits
+     * or crashes.
+     */
+    class ShmSink : public Sink {
+    public:
+        /**
+         * @brief Create the shared-memory segment
+         *
+         * @param name POSIX shared-memory name, e.g. "/dawglog"
+         * @param app_name Application name stored in the segment header
+         * @param slot_count Number of slots; rounded up to a power of two
+         * @param slot_bytes Size of a slot including its header; longer records are truncated
+         */
+        ShmSink(const std::string &name, const std::string &app_name, std::size_t slot_count = 8192,
+                std::size_t slot_bytes = 1024);
+        ~ShmSink() override;
+
+        ShmSink(const ShmSink &) = delete;
+        ShmSink &operator=(const ShmSink &) = delete;
+
+        void write(const Record &r, std::string_view formatted) override;
+
+        bool needs_formatting() const override { return false; }
+
+        /** The payload is copied into the slot after the message (cut like the message) */
+        bool writes_payload() const override { return true; }
+
+        /** @return Records dropped because the ring was full */
+        [[nodiscard]] std::uint64_t overruns() const;
+
+    private:
+        ShmRingHeader *header_{nullptr};
+        std::size_t size_{0};
+    };
+} // namespace DawgLog
@@ -1,9 +1,16 @@
 #pragma once
 #include "../record.hpp"
 #include <memory>
+#include <span>
 #include <string_view>
 
 namespace DawgLog {
+    /** A record of a write_batch() call together with its formatted text */
+    struct SinkEntry {
+        const Record *rec;
+        std::string_view formatted;
+    };
+
     /**
      * @brief Abstract base class for log sinks
      *
@@ -30,6 +37,38 @@ namespace DawgLog {
          * @param formatted The pre-formatted string representation of the log record
          */
         virtual void write(const Record &r, std::string_view formatted) = 0;
+
+        /**
+         * @brief Write several records at once, in order
+         *
+         * Called for LogBatch commits and by target queue writer threads. The default
+         * calls write() for each entry; sinks override it to take their lock once and
+         * hand the whole batch to the OS in one call.
+         *
+         * @param entries Records with their formatted text
+         */
+        virtual void write_batch(std::span<const SinkEntry> entries) {
+            for (const auto &entry : entries) {
+                write(*entry.rec, entry.formatted);
+            }
+        }
+
+        /**
+         * @brief Whether write() uses the formatted text
+         *
+         * Sinks that forward raw records (e.g. ShmSink) return false, and the logger
+         * then skips the target formatter and passes an empty string.
+         */
+        virtual bool needs_formatting() const { return true; }
+
+        /**
+         * @brief Whether write() writes Record::payload itself
+         *
+         * Sinks returning true get the formatted header only and write the payload
+         * after it without copying it (file, console, syslog, journald). For other
+         * sinks the logger appends the payload to the formatted text.
+         */
+        virtual bool writes_payload() const { return false; }
     };
 
     /** Type alias for unique pointer to Sink */
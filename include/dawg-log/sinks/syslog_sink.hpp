@@ -1,5 +1,6 @@
 #pragma once
 #include "sink.hpp"
+#include <cstddef>
 #include <string>
 
 namespace DawgLog {
@@ -11,14 +12,19 @@ namespace DawgLog {
      * the source of log messages in the syslog.
      *
      * This sink is typically used on Unix-like systems where syslog is available.
+     *
+     * Syslog daemons truncate long messages (rsyslog at 8 KiB by default), so a record
+     * payload that does not fit is split into several messages, each repeating the
+     * header followed by `[part/parts] ` and the next piece of the payload.
      */
     class SyslogSink : public Sink {
     public:
         /**
          * @brief Construct a new SyslogSink with the specified application name
          * @param app_name The name to use as the application identifier in syslog
+         * @param max_message_bytes Longest message passed to syslog() when splitting payloads
          */
-        explicit SyslogSink(std::string app_name);
+        explicit SyslogSink(std::string app_name, std::size_t max_message_bytes = 8192);
 
         /**
          * @brief Destroy the SyslogSink instance
@@ -34,7 +40,10 @@ namespace DawgLog {
          */
         void write(const Record &r, std::string_view formatted) override;
 
+        bool writes_payload() const override { return true; }
+
     private:
         std::string app_;
+        std::size_t max_message_bytes_;
     };
 } // namespace DawgLog
@@ -0,0 +1,42 @@
+#pragma once
+#include "sink.hpp"
+#include "../formatters/trace_event_formatter.hpp"
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace DawgLog {
+    /**
+     * @brief Writes records as a Chrome Trace Event JSON array
+     *
+     * Every record is written as one event (see TraceEventFormatter), so the file opens
+     * directly in Perfetto or chrome://tracing. Named threads get a `thread_name`
+     * metadata event. The closing `]` is written when the sink is destroyed; the trace
+     * format accepts a file without it, so a trace cut short by a crash still loads.
+     *
+     * The sink formats records itself; the target formatter is not used.
+     */
+    class TraceFileSink : public Sink {
+    public:
+        explicit TraceFileSink(std::string path);
+
+        /** Close the JSON array */
+        ~TraceFileSink() override;
+
+        void write(const Record &r, std::string_view formatted) override;
+
+        bool needs_formatting() const override { return false; }
+
+    private:
+        void write_event_locked(const std::string &event);
+
+        std::string path_;
+        std::ofstream out_;
+        TraceEventFormatter formatter_;
+        std::unordered_set<std::uint32_t> named_threads_;
+        bool first_{true};
+        std::mutex m_;
+    };
+} // namespace DawgLog
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include "base_logger.hpp"
+#include "level.hpp"
+#include "src_location.hpp"
+#include "tagged_logger.hpp"
+#include "thread_info.hpp"
+
+namespace DawgLog {
+    /**
+     * @brief RAII timing span
+     *
+     * Reads the monotonic clock when it is created and again when it is destroyed, and
+     * then writes a single record: the span name as message, `span_ns` set to the
+     * duration. Nothing is written when the span starts. If the level is filtered out
+     * for the tag, the span does not read the clock at all.
+     *
+     * Usage example:
+     * ```cpp
+     * DawgLog::TaggedLogger db("db");
+     * void load() {
+     *     DAWGLOG_SPAN(db, "load");
+     *     ...
+     * }
+     * ```
+     */
+    class ScopedSpan {
+    public:
+        /**
+         * @brief Start a span
+         * @param logger Tagged logger that writes the span record
+         * @param name Span name; must outlive the span (a string literal with DAWGLOG_SPAN)
+         * @param src Source location of the span
+         * @param lvl Level of the span record
+         */
+        ScopedSpan(TaggedLogger &logger, std::string_view name, const SourceLocation &src,
+                   LogLevel lvl = LogLevel::info)
+            : logger_(logger), name_(name), src_(src), lvl_(lvl),
+              start_ns_(logger.should_log(lvl) ? monotonic_ns() : 0) {
+        }
+
+        /** End the span and write its record */
+        ~ScopedSpan() {
+            if (start_ns_ != 0) {
+                Logger::instance().span(lvl_, logger_.interned_tag(), src_, name_, start_ns_, monotonic_ns());
+            }
+        }
+
+        ScopedSpan(const ScopedSpan &) = delete;
+        ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+    private:
+        TaggedLogger &logger_;
+        std::string_view name_;
+        SourceLocation src_;
+        LogLevel lvl_;
+        std::uint64_t start_ns_;
+    };
+
+#define DAWGLOG_SPAN_CONCAT_(a, b) a##b
+#define DAWGLOG_SPAN_CONCAT(a, b) DAWGLOG_SPAN_CONCAT_(a, b)
+
+    /** Time the rest of the enclosing scope as a span of a TaggedLogger */
+#define DAWGLOG_SPAN(logger, name) \
+    ::DawgLog::ScopedSpan DAWGLOG_SPAN_CONCAT(dawglog_span_, __LINE__){(logger), (name), LOG_SRC}
+} // namespace DawgLog
@@ -0,0 +1,203 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <fmt/core.h>
+#include "concepts.hpp"
+#include "level.hpp"
+#include "record.hpp"
+#include "src_location.hpp"
+#include "tag_registry.hpp"
+#include "target_filter.hpp"
+
+namespace DawgLog {
+    /**
+     * @brief Sink and formatter pair of a StaticLogger, both held by value
+     *
+     * The sink and the formatter are called through their concrete types, so the calls
+     * are direct (and inlinable where the definitions are visible) even when the types
+     * derive from Sink and Formatter. Any type with the same member functions works.
+     *
+     * @tparam S Sink type
+     * @tparam F Formatter type
+     */
+    template<StaticSinkType S, StaticFormatterType F>
+    class StaticTarget {
+    public:
+        StaticTarget() = default;
+
+        /**
+         * @brief Construct the sink (and optionally the formatter) from argument tuples
+         *
+         * Usage example: `StaticTarget<FileSink, TextFormatter>{std::forward_as_tuple("app.log")}`
+         *
+         * @param sink_args Arguments of the sink constructor
+         * @param formatter_args Arguments of the formatter constructor
+         */
+        template<typename... SinkArgs, typename... FormatterArgs>
+        explicit StaticTarget(std::tuple<SinkArgs...> sink_args, std::tuple<FormatterArgs...> formatter_args = {})
+            : sink_(std::make_from_tuple<S>(std::move(sink_args))),
+              formatter_(std::make_from_tuple<F>(std::move(formatter_args))) {
+        }
+
+        void write(const Record &rec) {
+            if (!filter.accepts(rec)) {
+                return;
+            }
+            bool needs_formatting = true;
+            if constexpr (requires { sink_.needs_formatting(); }) {
+                needs_formatting = sink_.S::needs_formatting();
+            }
+            if (needs_formatting) {
+                sink_.S::write(rec, formatter_.F::format(rec));
+            } else {
+                sink_.S::write(rec, std::string_view{});
+            }
+        }
+
+        [[nodiscard]] S &sink() { return sink_; }
+        [[nodiscard]] F &formatter() { return formatter_; }
+
+        /** Records this target writes */
+        TargetFilter filter;
+
+    private:
+        S sink_;
+        F formatter_;
+    };
+
+    template<typename L>
+    class StaticTaggedLogger;
+
+    /**
+     * @brief Logger with a target list fixed at compile time
+     *
+     * An alternative to Logger for services whose logging setup never changes at
+     * runtime. There is no virtual call and no pointer chase per target: log() formats
+     * the message, builds the record and calls each target's formatter and sink
+     * directly. The logger lock only keeps the record order identical in all targets.
+     * The level, per-tag level overrides (TagRegistry) and target filters work as for
+     * Logger; the flight recorder, queues and the memory budget are Logger-only.
+     *
+     * Usage example:
+     * ```cpp
+     * using AppLogger = DawgLog::StaticLogger<DawgLog::StaticTarget<DawgLog::FileSink, DawgLog::TextFormatter>,
+     *                                         DawgLog::StaticTarget<DawgLog::SyslogSink, DawgLog::JsonFormatter>>;
+     * AppLogger logger{"app", std::forward_as_tuple("app.log"), std::forward_as_tuple("app")};
+     * auto net = logger.tagged("net");
+     * TAG_INFO(net, "connected to {}", host);
+     * ```
+     *
+     * @tparam Targets StaticTarget types
+     */
+    template<typename... Targets>
+    class StaticLogger {
+    public:
+        /**
+         * @brief Construct the logger and its targets
+         * @param app_name Name of the application written into every record
+         * @param args One constructor argument per target (usually a tuple of sink arguments),
+         *             or none to default-construct all targets
+         */
+        template<typename... Args>
+        explicit StaticLogger(std::string app_name, Args &&... args)
+            : app_name_(std::move(app_name)), targets_(std::forward<Args>(args)...) {
+        }
+
+        StaticLogger(const StaticLogger &) = delete;
+        StaticLogger &operator=(const StaticLogger &) = delete;
+
+        /**
+         * @brief Log a message at the specified level
+         *
+         * @param lvl The severity level of this log message
+         * @param tag Interned tag for categorizing the log message
+         * @param src Source location information where the log was generated
+         * @param fmt_str Format string using fmt library syntax
+         * @param args Arguments to be formatted into the message
+         * @return formatted string (the message), empty if the level is filtered out
+         */
+        template<typename... Args>
+        std::string log(LogLevel lvl, const Tag &tag, const SourceLocation &src,
+                        fmt::string_view fmt_str, Args &&... args) {
+            if (!enabled(lvl, tag.id)) {
+                return {};
+            }
+            std::string msg = fmt::vformat(fmt_str, fmt::make_format_args(args...));
+            std::lock_guard<std::mutex> lock(m_);
+            const Record rec{lvl, tag, src, app_name_, msg};
+            std::apply([&rec](auto &... target) { (target.write(rec), ...); }, targets_);
+            return msg;
+        }
+
+        /** @return true if records of this level and tag are written (tag overrides first) */
+        [[nodiscard]] bool enabled(LogLevel lvl, TagId tag) const {
+            const auto override_level = TagRegistry::level(tag);
+            return lvl >= (override_level ? *override_level : level());
+        }
+
+        [[nodiscard]] LogLevel level() const { return level_.load(std::memory_order_relaxed); }
+
+        void set_level(LogLevel lvl) { level_.store(lvl, std::memory_order_relaxed); }
+
+        /** @return Target `I` of the logger */
+        template<std::size_t I>
+        [[nodiscard]] auto &target() { return std::get<I>(targets_); }
+
+        /**
+         * @brief Get a frontend for a tag, usable with the TAG_* macros
+         * @param tag The tag name, interned once here
+         */
+        [[nodiscard]] StaticTaggedLogger<StaticLogger> tagged(std::string_view tag) {
+            return StaticTaggedLogger<StaticLogger>(*this, TagRegistry::intern(tag));
+        }
+
+    private:
+        std::string app_name_;
+        std::atomic<LogLevel> level_{LogLevel::debug};
+        std::mutex m_;
+        std::tuple<Targets...> targets_;
+    };
+
+    /**
+     * @brief TaggedLogger counterpart for a StaticLogger
+     *
+     * Has the same should_log() and level functions as TaggedLogger, so the TAG_DEBUG
+     * ... TAG_CRITICAL macros accept it unchanged.
+     *
+     * @tparam L The StaticLogger type
+     */
+    template<typename L>
+    class StaticTaggedLogger {
+    public:
+        StaticTaggedLogger(L &logger, const Tag &tag) : logger_(&logger), tag_(tag) {
+        }
+
+        /** @return true if a record of this level is written for this tag */
+        [[nodiscard]] bool should_log(LogLevel lvl) const { return logger_->enabled(lvl, tag_.id); }
+
+#define X(name, general, str, syslog) \
+    template <typename... Args> \
+    void name(const SourceLocation& src, fmt::string_view fmt_str, Args&&... args) { \
+        logger_->log(LogLevel::name, tag_, src, fmt_str, std::forward<Args>(args)...); \
+    }
+        LOG_LEVELS_XMACRO
+#undef X
+
+        template<ExceptionType E, typename... Args>
+        void throw_error(const SourceLocation &src, fmt::string_view fmt_str, Args &&... args) {
+            logger_->log(LogLevel::error, tag_, src, fmt_str, args...);
+            throw E{fmt::vformat(fmt_str, fmt::make_format_args(args...))};
+        }
+
+        [[nodiscard]] const Tag &interned_tag() const { return tag_; }
+
+    private:
+        L *logger_;
+        Tag tag_;
+    };
+} // namespace DawgLog
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "level.hpp"
+
+namespace DawgLog {
+    /** Process-wide ID of an interned tag; IDs are dense and start at 0 */
+    using TagId = std::uint32_t;
+
+    /**
+     * @brief An interned tag: its stable ID and a view of its stable name
+     *
+     * The name view stays valid for the lifetime of the process, so records and
+     * handles can carry it without copying the tag string.
+     */
+    struct Tag {
+        TagId id{0};
+        std::string_view name;
+    };
+
+    /**
+     * @brief Global table of interned tags
+     *
+     * Tags are interned once (usually when a TaggedLogger is constructed) and never
+     * removed. Besides the name, every tag carries an optional level override that
+     * takes precedence over the logger level for records with that tag. Looking up
+     * a name or a level by ID is lock-free; interning takes a lock.
+     */
+    class TagRegistry {
+    public:
+        /** Maximum number of distinct tags in a process */
+        static constexpr std::size_t kMaxTags = 1 << 20;
+
+        /**
+         * @brief Intern a tag name
+         *
+         * @param name The tag name
+         * @return Tag The ID and stable name of the tag
+         */
+        static Tag intern(std::string_view name);
+
+        /**
+         * @brief Get the name of an interned tag
+         * @param id ID returned by intern()
+         * @return const std::string& The stable tag name
+         */
+        static const std::string &name(TagId id);
+
+        /** @return The level override of a tag, if any */
+        static std::optional<LogLevel> level(TagId id);
+
+        /**
+         * @brief Set or clear the level override of a tag
+         * @param id ID returned by intern()
+         * @param lvl New override, or std::nullopt to follow the logger level
+         */
+        static void set_level(TagId id, std::optional<LogLevel> lvl);
+
+        /** Remove the level overrides of all tags */
+        static void clear_levels();
+
+        /** @return Number of interned tags */
+        static std::size_t size();
+    };
+} // namespace DawgLog
@@ -1,8 +1,12 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include "base_logger.hpp"
 #include "level.hpp"
 #include "concepts.hpp"
+#include "tag_registry.hpp"
 
 namespace DawgLog {
     /**
@@ -11,6 +15,10 @@ namespace DawgLog {
      * The TaggedLogger provides a way to categorize log messages by associating them
      * with a descriptive tag. This allows for easier filtering and organization of logs.
      *
+     * The tag is interned once on construction. The handle caches the global logger
+     * and the resolved level of its tag, and refreshes them only when
+     * Logger::config_epoch() changes, so a filtered-out call costs two atomic loads.
+     *
      * Usage example:
      * ```cpp
      * TaggedLogger logger("Network");
@@ -23,8 +31,27 @@ namespace DawgLog {
          * @brief Construct a new TaggedLogger with the specified tag
          * @param tag The tag to associate with this logger instance
          */
-        explicit TaggedLogger(std::string tag)
-            : tag_(std::move(tag)) {
+        explicit TaggedLogger(std::string_view tag)
+            : tag_(TagRegistry::intern(tag)) {
+        }
+
+        TaggedLogger(const TaggedLogger &other) : tag_(other.tag_) {
+        }
+
+        TaggedLogger &operator=(const TaggedLogger &other) {
+            tag_ = other.tag_;
+            epoch_.store(0, std::memory_order_release);
+            return *this;
+        }
+
+        /**
+         * @brief Check whether a log call at this level has any effect for this tag
+         * @param lvl The level to check
+         * @return true if a record of this level is written or captured
+         */
+        bool should_log(LogLevel lvl) {
+            resolve();
+            return lvl >= level_.load(std::memory_order_relaxed) || recording_.load(std::memory_order_relaxed);
         }
 
         /**
@@ -37,14 +64,38 @@ namespace DawgLog {
 #define X(name, general, str, syslog) \
     template <typename... Args> \
     void name(const SourceLocation& src, fmt::string_view fmt_str, Args&&... args) { \
-        Logger::instance().log(LogLevel::name, tag_, src, fmt_str, std::forward<Args>(args)...); \
+        if (should_log(LogLevel::name)) { \
+            logger_.load(std::memory_order_relaxed)->log(LogLevel::name, tag_, src, fmt_str, std::forward<Args>(args)...); \
+        } \
     }
         LOG_LEVELS_XMACRO
 #undef X
 
+        /**
+         * @brief Log a message with a large body written without copies (see Logger::log_payload())
+         * @param lvl The severity level of this log message
+         * @param src Source location information for the log call
+         * @param body The body, only read during the call
+         * @param fmt_str Format string for the header message
+         * @param args Arguments to format into the message
+         */
+        template<typename... Args>
+        void payload(LogLevel lvl, const SourceLocation &src, std::string_view body, fmt::string_view fmt_str,
+                     Args &&... args) {
+            if (should_log(lvl)) {
+                logger_.load(std::memory_order_relaxed)->log_payload(lvl, tag_, src, body, fmt_str,
+                                                                     std::forward<Args>(args)...);
+            }
+        }
+
         template<ExceptionType E, typename... Args>
-        void throw_error(const SourceLocation& src, fmt::string_view fmt_str, Args&&... args) { \
-            auto error_msg = Logger::instance().log(LogLevel::error, tag_, src, fmt_str, std::forward<Args>(args)...); \
+        void throw_error(const SourceLocation& src, fmt::string_view fmt_str, Args&&... args) {
+            auto& logger = resolve();
+            if (!logger.enabled(LogLevel::error, tag_.id)) {
+                logger.flush_flight_recorder();
+                throw E{Logger::format_message(fmt_str, std::forward<Args>(args)...)};
+            }
+            auto error_msg = logger.log(LogLevel::error, tag_, src, fmt_str, std::forward<Args>(args)...);
             throw E{error_msg};
         }
 
@@ -52,9 +103,31 @@ namespace DawgLog {
          * @brief Get the tag associated with this logger
          * @return const std::string& Reference to the tag string
          */
-        [[nodiscard]] const std::string &tag() const { return tag_; }
+        [[nodiscard]] const std::string &tag() const { return TagRegistry::name(tag_.id); }
+
+        /** @return ID of the interned tag */
+        [[nodiscard]] TagId tag_id() const { return tag_.id; }
+
+        /** @return The interned tag */
+        [[nodiscard]] const Tag &interned_tag() const { return tag_; }
 
     private:
-        std::string tag_;
+        Logger &resolve() {
+            const auto epoch = Logger::config_epoch();
+            if (epoch_.load(std::memory_order_acquire) != epoch) {
+                auto &logger = Logger::instance();
+                logger_.store(&logger, std::memory_order_relaxed);
+                level_.store(logger.level_for(tag_.id), std::memory_order_relaxed);
+                recording_.store(logger.is_recording(), std::memory_order_relaxed);
+                epoch_.store(epoch, std::memory_order_release);
+            }
+            return *logger_.load(std::memory_order_relaxed);
+        }
+
+        Tag tag_;
+        std::atomic<std::uint64_t> epoch_{0};
+        std::atomic<Logger *> logger_{nullptr};
+        std::atomic<LogLevel> level_{LogLevel::debug};
+        std::atomic<bool> recording_{false};
     };
 } // namespace DawgLog
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "level.hpp"
+#include "record.hpp"
+#include "tag_registry.hpp"
+
+namespace DawgLog {
+    /**
+     * @brief Per-target record filter, evaluated before the target formatter runs
+     *
+     * Tag lists are interned when the filter is built and turned into bitsets indexed
+     * by TagId, so checking a tag costs a shift and a mask. Source patterns are shell
+     * wildcards (`fnmatch`) matched against the source file of the record. They are
+     * only evaluated for records that pass the level and tag checks.
+     *
+     * A default-constructed filter accepts every record.
+     */
+    class TargetFilter {
+    public:
+        struct Options {
+            /** Records below this level are skipped by the target */
+            LogLevel min_level{LogLevel::debug};
+
+            /** If not empty, only these tags are written */
+            std::vector<std::string> include_tags;
+
+            /** Tags never written by the target */
+            std::vector<std::string> exclude_tags;
+
+            /** If not empty, only records from matching source files are written */
+            std::vector<std::string> include_sources;
+
+            /** Source file patterns never written by the target */
+            std::vector<std::string> exclude_sources;
+        };
+
+        TargetFilter() = default;
+
+        explicit TargetFilter(const Options &options);
+
+        /**
+         * @brief Check whether the target writes a record
+         * @param rec The record
+         * @return true if the record passes the level, tag and source filters
+         */
+        [[nodiscard]] bool accepts(const Record &rec) const {
+            if (rec.level < min_level_) {
+                return false;
+            }
+            if (!include_tags_.empty() && !contains(include_tags_, rec.tag_id)) {
+                return false;
+            }
+            if (contains(exclude_tags_, rec.tag_id)) {
+                return false;
+            }
+            return !has_sources_ || accepts_source(rec.src.file);
+        }
+
+    private:
+        using Bitset = std::vector<std::uint64_t>;
+
+        static Bitset make_bitset(const std::vector<std::string> &tags);
+
+        static bool contains(const Bitset &bits, TagId id) {
+            const auto word = id / 64;
+            return word < bits.size() && (bits[word] >> (id % 64) & 1U) != 0;
+        }
+
+        [[nodiscard]] bool accepts_source(const char *file) const;
+
+        LogLevel min_level_{LogLevel::debug};
+        Bitset include_tags_;
+        Bitset exclude_tags_;
+        std::vector<std::string> include_sources_;
+        std::vector<std::string> exclude_sources_;
+        bool has_sources_{false};
+    };
+} // namespace DawgLog
@@ -0,0 +1,175 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include "backend.hpp"
+#include "formatters/formatter.hpp"
+#include "memory_budget.hpp"
+#include "record.hpp"
+#include "sinks/sink.hpp"
+
+namespace DawgLog {
+    /**
+     * @brief Bounded queue and writer thread in front of a single sink
+     *
+     * A target with a queue hands its formatted records to the queue instead of
+     * writing them in the logging thread. The writer thread writes them to the sink
+     * in order. A slow or stalled sink therefore only fills its own queue. When the
+     * queue is full (by record count or by bytes), the overflow policy decides
+     * whether the new record or the oldest queued record is dropped, or whether the
+     * caller waits for free space.
+     *
+     * With `format_workers` set, the queue also formats the records: producers queue
+     * them unformatted, and the writer thread splits each batch across copies of the
+     * target formatter on that many threads before writing the batch in order.
+     */
+    class TargetQueue {
+    public:
+        enum class Overflow {
+            DROP_NEWEST,
+            DROP_OLDEST,
+            BLOCK
+        };
+
+        struct Options {
+            /** Maximum number of queued records */
+            std::size_t capacity{8192};
+
+            /** Maximum bytes of queued messages and formatted text */
+            std::size_t max_bytes{8 << 20};
+
+            Overflow overflow{Overflow::DROP_NEWEST};
+
+            /** Affinity, scheduling and idle wait strategy of the writer thread */
+            BackendOptions backend;
+
+            /** Global budget shared with the other queues; records it refuses are shed */
+            std::shared_ptr<MemoryBudget> budget;
+
+            /**
+             * Threads formatting queued records, the writer thread included; 0 leaves
+             * formatting to the logging thread
+             */
+            std::size_t format_workers{0};
+
+            /** Resource of the queued records and queue nodes; nullptr uses log_memory_resource() */
+            std::pmr::memory_resource *memory_resource{nullptr};
+        };
+
+        /**
+         * @brief Start a writer thread for a sink
+         * @param sink Sink written by the writer thread; must outlive the queue
+         * @param options Queue limits and overflow policy
+         * @param formatter Target formatter, copied for the format workers; without it
+         *                  (or if it cannot be cloned) records must be queued formatted
+         */
+        TargetQueue(Sink &sink, Options options, const Formatter *formatter = nullptr);
+
+        /** Write the remaining records and stop the writer thread */
+        ~TargetQueue();
+
+        TargetQueue(const TargetQueue &) = delete;
+        TargetQueue &operator=(const TargetQueue &) = delete;
+
+        /**
+         * @brief Queue a record for the writer thread
+         * @param rec The record
+         * @param formatted Output of the target formatter for this record, empty if
+         *                  formats_records()
+         */
+        void push(const Record &rec, std::string formatted);
+
+        /**
+         * @brief Queue several records under one lock, in order
+         * @param entries Records with the output of the target formatter
+         */
+        void push_batch(std::span<const SinkEntry> entries);
+
+        /** Wait until every queued record was written to the sink */
+        void flush();
+
+        /** @return Number of records dropped by the overflow policy */
+        [[nodiscard]] std::uint64_t dropped() const;
+
+        [[nodiscard]] const Options &options() const { return options_; }
+
+        /** @return true if the queue formats records itself, so they are pushed unformatted */
+        [[nodiscard]] bool formats_records() const { return pool_ != nullptr; }
+
+    private:
+        struct Item {
+            Record rec;
+            std::string formatted;
+            /** Owned copy of the borrowed rec.payload; rec.payload is re-pointed after moves */
+            std::pmr::string payload;
+
+            [[nodiscard]] std::size_t bytes() const {
+                return rec.message.size() + formatted.size() + payload.size();
+            }
+
+            void bind_payload() {
+                if (!payload.empty()) {
+                    rec.payload = payload;
+                }
+            }
+        };
+
+        class FormatPool;
+
+        [[nodiscard]] Item make_item(const Record &rec, std::string formatted) const;
+        [[nodiscard]] bool full(std::size_t incoming) const;
+        void enqueue_locked(Item item, std::unique_lock<std::mutex> &lock);
+        void notify_pending();
+        void release(std::size_t bytes);
+        void wait_for_work(std::unique_lock<std::mutex> &lock);
+        void run();
+
+        Sink &sink_;
+        Options options_;
+        std::pmr::memory_resource *resource_;
+        std::pmr::deque<Item> items_;
+        std::size_t bytes_{0};
+        std::uint64_t dropped_{0};
+        /** Records taken by the writer thread but not yet written; count towards the limits */
+        std::size_t writing_{0};
+        bool stop_{false};
+        /** Set by producers, polled without the lock by the spinning and sleeping wait strategies */
+        std::atomic<bool> pending_{false};
+        mutable std::mutex m_;
+        std::condition_variable work_cv_;
+        std::condition_variable space_cv_;
+        std::unique_ptr<FormatPool> pool_;
+        std::thread worker_;
+    };
+
+    /**
+     * @brief Parse an overflow policy name (`drop_newest`, `drop_oldest`, `block`)
+     * @param name Policy name from the configuration
+     * @return TargetQueue::Overflow The policy, drop_newest for unknown names
+     */
+    TargetQueue::Overflow string_to_overflow(const std::string &name);
+
+    /**
+     * @brief Format a record for a sink and decide who writes its payload
+     *
+     * Without a payload this is `formatter.format(rec)`. A payload ends up in the
+     * returned text (embedded by the formatter, or appended to the header for sinks
+     * that do not write payloads) unless the sink writes it after the header itself.
+     *
+     * @param formatter The target formatter
+     * @param sink The target sink
+     * @param rec The record
+     * @param sink_writes_payload Set to whether the sink still has to write `rec.payload`
+     * @return std::string The formatted text
+     */
+    std::string format_for_sink(Formatter &formatter, const Sink &sink, const Record &rec,
+                                bool &sink_writes_payload);
+} // namespace DawgLog
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace DawgLog {
+    /**
+     * @brief Identity of a logging thread
+     *
+     * Looked up once per thread and cached in thread-local storage, so reading it
+     * on the logging path costs no system call.
+     */
+    struct ThreadInfo {
+        /** Kernel thread ID (`gettid`) */
+        std::uint32_t id{0};
+
+        /** Thread name (at most 15 characters on Linux), may be empty */
+        std::string name;
+    };
+
+    /**
+     * @brief Get the cached identity of the calling thread
+     * @return const ThreadInfo& Thread-local info, valid for the lifetime of the thread
+     */
+    const ThreadInfo &current_thread();
+
+    /**
+     * @brief Name the calling thread
+     *
+     * Updates the cached name used in records and the kernel thread name shown by
+     * tools such as `top -H`.
+     *
+     * @param name New thread name; truncated to 15 characters
+     */
+    void set_thread_name(std::string_view name);
+
+    /**
+     * @brief Get the CPU the calling thread runs on
+     *
+     * Uses `sched_getcpu`, which glibc answers from the rseq area or the vDSO
+     * without entering the kernel.
+     *
+     * @return int CPU number, or -1 if unknown
+     */
+    int current_cpu();
+
+    /** @return Monotonic clock reading in nanoseconds */
+    std::uint64_t monotonic_ns();
+} // namespace DawgLog
@@ -1,17 +1,28 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <map>
+#include "level.hpp"
 
 namespace DawgLog {
     enum class SinkType {
         CONSOLE,
         SYSLOG,
-        FILE
+        FILE,
+        COMPRESSED_FILE,
+        ARCHIVE,
+        NETWORK,
+        SHM,
+        JOURNALD,
+        SHARDED_FILE,
+        TRACE
     };
 
     enum class FormatterType {
         JSON,
-        TEXT
+        TEXT,
+        TRACE
     };
 
     /**
@@ -26,6 +37,22 @@ namespace DawgLog {
      */
     std::string make_timestamp();
 
+    /**
+     * @brief Formats the given time point as an HH:MM:SS local-time string
+     *
+     * @param time The wall-clock time point to format
+     * @return std::string Formatted timestamp in "HH:MM:SS" format
+     */
+    std::string make_timestamp(std::chrono::system_clock::time_point time);
+
+    /**
+     * @brief Converts a wall-clock time point to milliseconds since the Unix epoch
+     *
+     * @param time The wall-clock time point to convert
+     * @return std::int64_t Milliseconds since 1970-01-01T00:00:00Z
+     */
+    std::int64_t to_epoch_ms(std::chrono::system_clock::time_point time);
+
     /**
      * @brief Gets the static mapping of sink type strings to SinkType enum values
      *
@@ -71,4 +98,16 @@ namespace DawgLog {
      * @return FormatterType The corresponding FormatterType enum value
      */
     FormatterType string_to_formatter_type(const std::string &type);
+
+    /**
+     * @brief Converts a level name to a LogLevel enum value
+     *
+     * Accepts the names understood by parse_level(). If the name is not recognized,
+     * it returns the given fallback level.
+     *
+     * @param name The level name to convert
+     * @param fallback Level returned for unknown names
+     * @return LogLevel The corresponding LogLevel enum value
+     */
+    LogLevel string_to_level(const std::string &name, LogLevel fallback);
 } // namespace DawgLog
@@ -0,0 +1,185 @@
+#include "dawg-log/archive.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace DawgLog;
+
+namespace {
+constexpr unsigned kBloomHashes = 3;
+
+bool is_word_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+std::uint64_t fnv1a64(std::string_view s) {
+    std::uint64_t h = 1469598103934665603ull;
+    for (const char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+template<typename T>
+T load(const char *p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+}
+
+std::uint32_t DawgLog::archive_tag_id(std::string_view tag) {
+    std::uint32_t h = 2166136261u;
+    for (const char c : tag) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void DawgLog::archive_tokenize(std::string_view text, const std::function<void(std::string_view)>& fn) {
+    std::size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !is_word_char(text[i])) {
+            ++i;
+        }
+        const auto start = i;
+        while (i < text.size() && is_word_char(text[i])) {
+            ++i;
+        }
+        if (i > start) {
+            fn(text.substr(start, i - start));
+        }
+    }
+}
+
+void DawgLog::archive_bloom_add(std::uint8_t* bloom, std::string_view token) {
+    const auto h = fnv1a64(token);
+    const auto h1 = static_cast<std::uint32_t>(h);
+    const auto h2 = static_cast<std::uint32_t>(h >> 32) | 1u;
+    for (unsigned k = 0; k < kBloomHashes; ++k) {
+        const auto bit = (h1 + k * h2) % (kArchiveBloomBytes * 8);
+        bloom[bit >> 3] |= static_cast<std::uint8_t>(1u << (bit & 7));
+    }
+}
+
+bool DawgLog::archive_bloom_may_contain(const std::uint8_t* bloom, std::string_view token) {
+    const auto h = fnv1a64(token);
+    const auto h1 = static_cast<std::uint32_t>(h);
+    const auto h2 = static_cast<std::uint32_t>(h >> 32) | 1u;
+    for (unsigned k = 0; k < kBloomHashes; ++k) {
+        const auto bit = (h1 + k * h2) % (kArchiveBloomBytes * 8);
+        if ((bloom[bit >> 3] & (1u << (bit & 7))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> DawgLog::archive_required_tokens(std::string_view query, bool whole_words) {
+    std::vector<std::string> tokens;
+    archive_tokenize(query, [&](std::string_view token) {
+        const auto start = static_cast<std::size_t>(token.data() - query.data());
+        const auto end = start + token.size();
+        if (whole_words || (start > 0 && end < query.size())) {
+            tokens.emplace_back(token);
+        }
+    });
+    return tokens;
+}
+
+bool ArchiveBlock::has_tag(std::uint32_t id) const {
+    for (std::uint32_t i = 0; i < header.tag_count; ++i) {
+        if (load<std::uint32_t>(reinterpret_cast<const char*>(tag_ids) + i * 4) == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ArchiveBlock::for_each_record(const std::function<void(const ArchiveRecord&)>& fn) const {
+    const char* p = payload;
+    const char* end = payload + header.payload_size;
+    while (p < end) {
+        if (static_cast<std::size_t>(end - p) < kArchiveRecordPrefix) {
+            return false;
+        }
+        ArchiveRecord rec;
+        rec.time_ms = load<std::int64_t>(p);
+        rec.level = static_cast<LogLevel>(load<std::uint8_t>(p + 8));
+        rec.tag_id = load<std::uint32_t>(p + 9);
+        const auto tag_len = load<std::uint16_t>(p + 13);
+        const auto line_len = load<std::uint32_t>(p + 15);
+        p += kArchiveRecordPrefix;
+        if (static_cast<std::size_t>(end - p) < std::size_t{tag_len} + line_len) {
+            return false;
+        }
+        rec.tag = std::string_view(p, tag_len);
+        rec.line = std::string_view(p + tag_len, line_len);
+        p += tag_len + line_len;
+        fn(rec);
+    }
+    return true;
+}
+
+ArchiveReader::ArchiveReader(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Failed to open log archive: " << path << std::endl;
+        return;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(kArchiveFileMagic))) {
+        ::close(fd);
+        return;
+    }
+    void* mapped = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Failed to map log archive: " << path << std::endl;
+        return;
+    }
+    data_ = static_cast<const char*>(mapped);
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (std::memcmp(data_, kArchiveFileMagic, sizeof(kArchiveFileMagic)) != 0) {
+        std::cerr << "Not a dawg-log archive: " << path << std::endl;
+        return;
+    }
+
+    std::size_t pos = sizeof(kArchiveFileMagic);
+    while (size_ - pos >= kArchiveBlockHeaderBytes + kArchiveBloomBytes) {
+        ArchiveBlock block;
+        const char* p = data_ + pos;
+        block.header.magic = load<std::uint32_t>(p);
+        block.header.records = load<std::uint32_t>(p + 4);
+        block.header.payload_size = load<std::uint64_t>(p + 8);
+        block.header.min_ms = load<std::int64_t>(p + 16);
+        block.header.max_ms = load<std::int64_t>(p + 24);
+        block.header.level_mask = load<std::uint32_t>(p + 32);
+        block.header.tag_count = load<std::uint32_t>(p + 36);
+        if (block.header.magic != kArchiveBlockMagic) {
+            std::cerr << "Corrupt block at offset " << pos << " in: " << path << std::endl;
+            break;
+        }
+        const std::size_t block_size = kArchiveBlockHeaderBytes + kArchiveBloomBytes +
+                                       std::size_t{block.header.tag_count} * 4 + block.header.payload_size;
+        if (block_size > size_ - pos) {
+            break;
+        }
+        block.bloom = reinterpret_cast<const std::uint8_t*>(p + kArchiveBlockHeaderBytes);
+        block.tag_ids = block.bloom + kArchiveBloomBytes;
+        block.payload = reinterpret_cast<const char*>(block.tag_ids) + std::size_t{block.header.tag_count} * 4;
+        blocks_.push_back(block);
+        pos += block_size;
+    }
+}
+
+ArchiveReader::~ArchiveReader() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
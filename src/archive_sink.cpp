@@ -0,0 +1,110 @@
+#include "dawg-log/sinks/archive_sink.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+using namespace DawgLog;
+
+namespace {
+template<typename T>
+void append(std::string& out, T value) {
+    char buf[sizeof(T)];
+    std::memcpy(buf, &value, sizeof(T));
+    out.append(buf, sizeof(T));
+}
+}
+
+ArchiveSink::ArchiveSink(std::string path, std::size_t block_bytes)
+    : path_(std::move(path)), block_bytes_(block_bytes == 0 ? kDefaultBlockBytes : block_bytes) {
+    std::error_code ec;
+    const bool fresh = !std::filesystem::exists(path_, ec) || std::filesystem::file_size(path_, ec) == 0;
+    out_.open(path_, std::ios::binary | std::ios::app);
+    if (!out_.is_open()) {
+        std::cerr << "Failed to open log archive: " << path_ << std::endl;
+        return;
+    }
+    if (fresh) {
+        out_.write(kArchiveFileMagic, sizeof(kArchiveFileMagic));
+        out_.flush();
+    }
+    payload_.reserve(block_bytes_ + 4096);
+}
+
+ArchiveSink::~ArchiveSink() {
+    std::lock_guard lock(m_);
+    flush_locked();
+}
+
+void ArchiveSink::write(const Record& r, std::string_view formatted) {
+    std::lock_guard lock(m_);
+    if (!out_.is_open()) {
+        return;
+    }
+    const auto ms = to_epoch_ms(r.time);
+    const auto tag = std::string_view(r.tag).substr(0, UINT16_MAX);
+    const auto tag_id = archive_tag_id(tag);
+
+    if (header_.records == 0) {
+        header_.min_ms = ms;
+        header_.max_ms = ms;
+    }
+    header_.min_ms = std::min(header_.min_ms, ms);
+    header_.max_ms = std::max(header_.max_ms, ms);
+    header_.level_mask |= archive_level_bit(r.level);
+    ++header_.records;
+    if (std::find(tag_ids_.begin(), tag_ids_.end(), tag_id) == tag_ids_.end()) {
+        tag_ids_.push_back(tag_id);
+    }
+    archive_tokenize(formatted, [this](std::string_view token) { archive_bloom_add(bloom_.data(), token); });
+
+    append<std::int64_t>(payload_, ms);
+    append<std::uint8_t>(payload_, static_cast<std::uint8_t>(r.level));
+    append<std::uint32_t>(payload_, tag_id);
+    append<std::uint16_t>(payload_, static_cast<std::uint16_t>(tag.size()));
+    append<std::uint32_t>(payload_, static_cast<std::uint32_t>(formatted.size()));
+    payload_.append(tag);
+    payload_.append(formatted);
+
+    if (payload_.size() >= block_bytes_) {
+        flush_locked();
+    }
+}
+
+void ArchiveSink::flush() {
+    std::lock_guard lock(m_);
+    flush_locked();
+}
+
+void ArchiveSink::flush_locked() {
+    if (header_.records == 0 || !out_.is_open()) {
+        return;
+    }
+    header_.payload_size = payload_.size();
+    header_.tag_count = static_cast<std::uint32_t>(tag_ids_.size());
+
+    std::string head;
+    head.reserve(kArchiveBlockHeaderBytes + kArchiveBloomBytes + tag_ids_.size() * 4);
+    append(head, header_.magic);
+    append(head, header_.records);
+    append(head, header_.payload_size);
+    append(head, header_.min_ms);
+    append(head, header_.max_ms);
+    append(head, header_.level_mask);
+    append(head, header_.tag_count);
+    head.append(reinterpret_cast<const char*>(bloom_.data()), bloom_.size());
+    for (const auto id : tag_ids_) {
+        append(head, id);
+    }
+    out_.write(head.data(), static_cast<std::streamsize>(head.size()));
+    out_.write(payload_.data(), static_cast<std::streamsize>(payload_.size()));
+    out_.flush();
+    reset_block();
+}
+
+void ArchiveSink::reset_block() {
+    header_ = ArchiveBlockHeader{};
+    bloom_.fill(0);
+    tag_ids_.clear();
+    payload_.clear();
+}
@@ -0,0 +1,88 @@
+#include "dawg-log/backend.hpp"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace DawgLog;
+
+namespace {
+int to_native(BackendOptions::SchedPolicy policy) {
+    switch (policy) {
+        case BackendOptions::SchedPolicy::BATCH:
+            return SCHED_BATCH;
+        case BackendOptions::SchedPolicy::IDLE:
+            return SCHED_IDLE;
+        case BackendOptions::SchedPolicy::FIFO:
+            return SCHED_FIFO;
+        case BackendOptions::SchedPolicy::RR:
+            return SCHED_RR;
+        default:
+            return SCHED_OTHER;
+    }
+}
+}
+
+void DawgLog::apply_backend_options(const BackendOptions& options) {
+    if (!options.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const int cpu : options.cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        if (const int err = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set); err != 0) {
+            std::cerr << "DawgLog: failed to set backend CPU affinity: " << std::strerror(err) << std::endl;
+        }
+    }
+
+    if (options.policy != BackendOptions::SchedPolicy::OTHER) {
+        const int policy = to_native(options.policy);
+        sched_param param{};
+        param.sched_priority = policy == SCHED_FIFO || policy == SCHED_RR ? options.priority : 0;
+        if (const int err = ::pthread_setschedparam(::pthread_self(), policy, &param); err != 0) {
+            std::cerr << "DawgLog: failed to set backend scheduling policy: " << std::strerror(err) << std::endl;
+        }
+    }
+
+    if (options.nice) {
+        const auto tid = static_cast<id_t>(::syscall(SYS_gettid));
+        if (::setpriority(PRIO_PROCESS, tid, *options.nice) != 0) {
+            std::cerr << "DawgLog: failed to set backend nice value: " << std::strerror(errno) << std::endl;
+        }
+    }
+}
+
+BackendOptions::SchedPolicy DawgLog::string_to_sched_policy(const std::string& name) {
+    if (name == "batch") {
+        return BackendOptions::SchedPolicy::BATCH;
+    }
+    if (name == "idle") {
+        return BackendOptions::SchedPolicy::IDLE;
+    }
+    if (name == "fifo") {
+        return BackendOptions::SchedPolicy::FIFO;
+    }
+    if (name == "rr") {
+        return BackendOptions::SchedPolicy::RR;
+    }
+    return BackendOptions::SchedPolicy::OTHER;
+}
+
+BackendOptions::Wait DawgLog::string_to_wait(const std::string& name) {
+    if (name == "spin") {
+        return BackendOptions::Wait::SPIN;
+    }
+    if (name == "spin_yield") {
+        return BackendOptions::Wait::SPIN_YIELD;
+    }
+    if (name == "sleep") {
+        return BackendOptions::Wait::SLEEP;
+    }
+    return BackendOptions::Wait::CONDVAR;
+}
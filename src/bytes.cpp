@@ -0,0 +1,211 @@
+#include "dawg-log/bytes.hpp"
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DAWGLOG_X86_SIMD 1
+#endif
+
+using namespace DawgLog;
+
+namespace {
+constexpr char kHexLower[] = "0123456789abcdef";
+constexpr char kHexUpper[] = "0123456789ABCDEF";
+constexpr char kBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr std::size_t kDumpRow = 16;
+// "00000010 " + 16 x " xx" + one extra space in the middle + "  |" + the characters + "|"
+constexpr std::size_t kDumpRowOverhead = 9 + 3 * kDumpRow + 1 + 3 + 1;
+
+// Input bytes encoded per chunk by format_bytes(): whole base64 groups and whole dump rows
+constexpr std::size_t kChunkBytes = 3 * kDumpRow * 64;
+// Largest chunk encoding: a dump, with a newline before every row
+constexpr std::size_t kChunkText = kChunkBytes / kDumpRow * (kDumpRowOverhead + kDumpRow + 1);
+
+inline std::uint8_t byte_at(const std::byte* p, std::size_t i) {
+    return static_cast<std::uint8_t>(p[i]);
+}
+
+char* hex_scalar(const std::byte* in, std::size_t n, char* out, const char* digits) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto b = byte_at(in, i);
+        *out++ = digits[b >> 4];
+        *out++ = digits[b & 0x0f];
+    }
+    return out;
+}
+
+char* base64_scalar(const std::byte* in, std::size_t n, char* out) {
+    std::size_t i = 0;
+    for (; i + 3 <= n; i += 3) {
+        const std::uint32_t v = byte_at(in, i) << 16 | byte_at(in, i + 1) << 8 | byte_at(in, i + 2);
+        *out++ = kBase64[v >> 18 & 0x3f];
+        *out++ = kBase64[v >> 12 & 0x3f];
+        *out++ = kBase64[v >> 6 & 0x3f];
+        *out++ = kBase64[v & 0x3f];
+    }
+    if (i < n) {
+        const std::uint32_t v = byte_at(in, i) << 16 | (i + 1 < n ? byte_at(in, i + 1) << 8 : 0);
+        *out++ = kBase64[v >> 18 & 0x3f];
+        *out++ = kBase64[v >> 12 & 0x3f];
+        *out++ = i + 1 < n ? kBase64[v >> 6 & 0x3f] : '=';
+        *out++ = '=';
+    }
+    return out;
+}
+
+#ifdef DAWGLOG_X86_SIMD
+// 32 bytes per step: split into nibbles, map them with a shuffle table and interleave
+__attribute__((target("avx2"))) char* hex_avx2(const std::byte* in, std::size_t n, char* out, const char* digits) {
+    const __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digits)));
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+        const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low_mask));
+        // Per 128-bit lane: bytes 0-7 and 8-15 of the lane, as digit pairs
+        const __m256i first = _mm256_unpacklo_epi8(hi, lo);
+        const __m256i second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), _mm256_permute2x128_si256(first, second, 0x31));
+        out += 64;
+    }
+    return hex_scalar(in + i, n - i, out, digits);
+}
+
+// 12 bytes per step into 16 characters (Muła's pshufb method); reads 16 bytes, so stops 4 early
+__attribute__((target("ssse3"))) char* base64_ssse3(const std::byte* in, std::size_t n, char* out) {
+    const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 12) {
+        const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), spread);
+        // Move the four 6-bit groups of each 3-byte word into separate bytes
+        const __m128i a = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        const __m128i b = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(a, b);
+        // Map 0-25, 26-51, 52-61, 62, 63 to their alphabet ranges with one table lookup
+        __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices));
+        out += 16;
+    }
+    return base64_scalar(in + i, n - i, out);
+}
+
+// Static initializers may run before the CPU model is known, hence the explicit init
+const bool has_avx2 = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+}();
+const bool has_ssse3 = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3") != 0;
+}();
+#endif
+
+char* hex(const std::byte* in, std::size_t n, char* out, const char* digits) {
+#ifdef DAWGLOG_X86_SIMD
+    if (has_avx2 && n >= 32) {
+        return hex_avx2(in, n, out, digits);
+    }
+#endif
+    return hex_scalar(in, n, out, digits);
+}
+
+char* base64(const std::byte* in, std::size_t n, char* out) {
+#ifdef DAWGLOG_X86_SIMD
+    if (has_ssse3 && n >= 16) {
+        return base64_ssse3(in, n, out);
+    }
+#endif
+    return base64_scalar(in, n, out);
+}
+
+// `offset` is the position of `in` in the whole data, printed at the start of each row
+char* dump(const std::byte* in, std::size_t n, char* out, std::size_t offset) {
+    for (std::size_t row = 0; row < n; row += kDumpRow) {
+        const auto count = std::min(kDumpRow, n - row);
+        if (row > 0) {
+            *out++ = '\n';
+        }
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            *out++ = kHexLower[(offset + row) >> shift & 0x0f];
+        }
+        *out++ = ' ';
+        for (std::size_t i = 0; i < kDumpRow; ++i) {
+            if (i == kDumpRow / 2) {
+                *out++ = ' ';
+            }
+            *out++ = ' ';
+            if (i < count) {
+                const auto b = byte_at(in, row + i);
+                *out++ = kHexLower[b >> 4];
+                *out++ = kHexLower[b & 0x0f];
+            } else {
+                *out++ = ' ';
+                *out++ = ' ';
+            }
+        }
+        *out++ = ' ';
+        *out++ = ' ';
+        *out++ = '|';
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto b = byte_at(in, row + i);
+            *out++ = b >= 0x20 && b < 0x7f ? static_cast<char>(b) : '.';
+        }
+        *out++ = '|';
+    }
+    return out;
+}
+}
+
+std::size_t DawgLog::encoded_size(BytesFormat format, std::size_t size) {
+    switch (format) {
+        case BytesFormat::HEX:
+        case BytesFormat::HEX_UPPER:
+            return 2 * size;
+        case BytesFormat::DUMP: {
+            const auto rows = (size + kDumpRow - 1) / kDumpRow;
+            return rows == 0 ? 0 : rows * kDumpRowOverhead + size + (rows - 1);
+        }
+        case BytesFormat::BASE64:
+            return (size + 2) / 3 * 4;
+    }
+    return 0;
+}
+
+char* DawgLog::encode_bytes(BytesFormat format, std::span<const std::byte> in, char* out) {
+    switch (format) {
+        case BytesFormat::HEX:
+            return hex(in.data(), in.size(), out, kHexLower);
+        case BytesFormat::HEX_UPPER:
+            return hex(in.data(), in.size(), out, kHexUpper);
+        case BytesFormat::DUMP:
+            return dump(in.data(), in.size(), out, 0);
+        case BytesFormat::BASE64:
+            return base64(in.data(), in.size(), out);
+    }
+    return out;
+}
+
+fmt::appender DawgLog::format_bytes(fmt::appender out, BytesFormat format, std::span<const std::byte> in) {
+    char chunk[kChunkText];
+    for (std::size_t done = 0; done < in.size(); done += kChunkBytes) {
+        const auto part = in.subspan(done, std::min(kChunkBytes, in.size() - done));
+        char* end = chunk;
+        if (format == BytesFormat::DUMP) {
+            if (done > 0) {
+                *end++ = '\n';
+            }
+            end = dump(part.data(), part.size(), end, done);
+        } else {
+            end = encode_bytes(format, part, end);
+        }
+        out = fmt::format_to(out, "{}", std::string_view(chunk, static_cast<std::size_t>(end - chunk)));
+    }
+    return out;
+}
@@ -0,0 +1,196 @@
+#include "dawg-log/sinks/compressed_file_sink.hpp"
+#include <iostream>
+#include <sstream>
+#include <zlib.h>
+
+using namespace DawgLog;
+
+namespace {
+constexpr std::size_t kMaxPendingFrames = 4;
+constexpr int kGzipWindowBits = 15 + 16;
+
+std::string index_path(const std::string& path) {
+    return path + ".idx";
+}
+
+bool compress_frame(std::string_view raw, std::string& out) {
+    z_stream zs{};
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, kGzipWindowBits, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    out.resize(deflateBound(&zs, raw.size()));
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(raw.data()));
+    zs.avail_in = static_cast<uInt>(raw.size());
+    zs.next_out = reinterpret_cast<Bytef*>(out.data());
+    zs.avail_out = static_cast<uInt>(out.size());
+    const int rc = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return rc == Z_STREAM_END;
+}
+
+bool decompress_frame(std::string_view compressed, std::size_t raw_size, std::string& out) {
+    z_stream zs{};
+    if (inflateInit2(&zs, kGzipWindowBits) != Z_OK) {
+        return false;
+    }
+    const auto base = out.size();
+    out.resize(base + raw_size);
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+    zs.avail_in = static_cast<uInt>(compressed.size());
+    zs.next_out = reinterpret_cast<Bytef*>(out.data() + base);
+    zs.avail_out = static_cast<uInt>(raw_size);
+    const int rc = inflate(&zs, Z_FINISH);
+    out.resize(base + zs.total_out);
+    inflateEnd(&zs);
+    return rc == Z_STREAM_END;
+}
+}
+
+CompressedFileSink::CompressedFileSink(std::string path,
+                                       std::size_t frame_bytes,
+                                       std::chrono::milliseconds flush_interval,
+                                       BackendOptions backend)
+    : path_(std::move(path)),
+      frame_bytes_(frame_bytes == 0 ? kDefaultFrameBytes : frame_bytes),
+      flush_interval_(flush_interval),
+      backend_(std::move(backend)),
+      out_(path_, std::ios::binary | std::ios::app),
+      index_(index_path(path_), std::ios::app) {
+    if (!out_.is_open() || !index_.is_open()) {
+        std::cerr << "Failed to open compressed log file: " << path_ << std::endl;
+    }
+    out_.seekp(0, std::ios::end);
+    const auto pos = out_.tellp();
+    offset_ = pos < 0 ? 0 : static_cast<std::uint64_t>(pos);
+    active_.data.reserve(frame_bytes_);
+    worker_ = std::thread([this] { run(); });
+}
+
+CompressedFileSink::~CompressedFileSink() {
+    {
+        std::lock_guard lock(m_);
+        seal_locked();
+        stop_ = true;
+    }
+    work_cv_.notify_one();
+    worker_.join();
+}
+
+void CompressedFileSink::write(const Record& r, std::string_view formatted) {
+    std::unique_lock lock(m_);
+    const auto ms = to_epoch_ms(r.time);
+    if (active_.records == 0) {
+        active_.first_ms = ms;
+    }
+    active_.last_ms = ms;
+    active_.data.append(formatted);
+    active_.data.push_back('\n');
+    ++active_.records;
+    if (active_.data.size() < frame_bytes_) {
+        return;
+    }
+    while (pending_.size() >= kMaxPendingFrames) {
+        idle_cv_.wait_for(lock, flush_interval_);
+    }
+    seal_locked();
+    work_cv_.notify_one();
+}
+
+void CompressedFileSink::flush() {
+    std::unique_lock lock(m_);
+    seal_locked();
+    work_cv_.notify_one();
+    while (!pending_.empty() || busy_) {
+        idle_cv_.wait_for(lock, flush_interval_);
+    }
+}
+
+void CompressedFileSink::seal_locked() {
+    if (active_.records == 0) {
+        return;
+    }
+    pending_.push_back(std::move(active_));
+    active_ = Frame{};
+    active_.data.reserve(frame_bytes_);
+}
+
+void CompressedFileSink::run() {
+    apply_backend_options(backend_);
+    std::unique_lock lock(m_);
+    while (true) {
+        if (pending_.empty()) {
+            if (stop_) {
+                return;
+            }
+            if (!work_cv_.wait_for(lock, flush_interval_, [this] { return stop_ || !pending_.empty(); })) {
+                seal_locked();
+            }
+            continue;
+        }
+        Frame frame = std::move(pending_.front());
+        pending_.pop_front();
+        busy_ = true;
+        lock.unlock();
+        write_frame(frame);
+        lock.lock();
+        busy_ = false;
+        idle_cv_.notify_all();
+    }
+}
+
+void CompressedFileSink::write_frame(const Frame& frame) {
+    if (!out_.is_open()) {
+        return;
+    }
+    std::string compressed;
+    if (!compress_frame(frame.data, compressed)) {
+        std::cerr << "Failed to compress log frame for: " << path_ << std::endl;
+        return;
+    }
+    out_.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+    out_.flush();
+    index_ << offset_ << ' ' << compressed.size() << ' ' << frame.data.size() << ' '
+           << frame.records << ' ' << frame.first_ms << ' ' << frame.last_ms << '\n';
+    index_.flush();
+    offset_ += compressed.size();
+}
+
+std::vector<CompressedFileSink::FrameIndexEntry> CompressedFileSink::read_index(const std::string& path) {
+    std::vector<FrameIndexEntry> entries;
+    std::ifstream in(index_path(path));
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream iss(line);
+        FrameIndexEntry e;
+        if (iss >> e.offset >> e.compressed_size >> e.raw_size >> e.records >> e.first_ms >> e.last_ms) {
+            entries.push_back(e);
+        }
+    }
+    return entries;
+}
+
+std::string CompressedFileSink::read_range(const std::string& path,
+                                           std::chrono::system_clock::time_point from,
+                                           std::chrono::system_clock::time_point to) {
+    const auto from_ms = to_epoch_ms(from);
+    const auto to_ms = to_epoch_ms(to);
+    std::ifstream in(path, std::ios::binary);
+    std::string result;
+    std::string compressed;
+    for (const auto& e : read_index(path)) {
+        if (e.last_ms < from_ms || e.first_ms > to_ms) {
+            continue;
+        }
+        compressed.resize(e.compressed_size);
+        in.seekg(static_cast<std::streamoff>(e.offset));
+        if (!in.read(compressed.data(), static_cast<std::streamsize>(compressed.size()))) {
+            break;
+        }
+        if (!decompress_frame(compressed, e.raw_size, result)) {
+            std::cerr << "Corrupt log frame at offset " << e.offset << " in: " << path << std::endl;
+        }
+    }
+    return result;
+}
@@ -6,10 +6,26 @@ using namespace DawgLog;
 void ConsoleSink::write(const Record& r, std::string_view formatted) {
     std::lock_guard lock(m_);
     if (r.level >= LogLevel::warning) {
-        std::cerr << formatted << '\n';
+        std::cerr << formatted << r.payload << '\n';
         std::cerr.flush();
     } else {
-        std::cout << formatted << '\n';
+        std::cout << formatted << r.payload << '\n';
         std::cout.flush();
     }
-}
\ No newline at end of file
+}
+
+void ConsoleSink::write_batch(std::span<const SinkEntry> entries) {
+    std::lock_guard lock(m_);
+    std::ostream* current = nullptr;
+    for (const auto& entry : entries) {
+        auto* out = entry.rec->level >= LogLevel::warning ? &std::cerr : &std::cout;
+        if (current != nullptr && current != out) {
+            current->flush();
+        }
+        current = out;
+        *out << entry.formatted << entry.rec->payload << '\n';
+    }
+    if (current != nullptr) {
+        current->flush();
+    }
+}
@@ -0,0 +1,63 @@
+#include "dawg-log/context.hpp"
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+using namespace DawgLog;
+
+namespace {
+thread_local ContextPtr current;
+
+nlohmann::json to_json(const ContextField& field) {
+    switch (field.kind) {
+        case ContextField::Kind::BOOL:
+            return field.value == "true";
+        case ContextField::Kind::NUMBER: {
+            auto number = nlohmann::json::parse(field.value, nullptr, false);
+            return number.is_number() ? number : nlohmann::json(field.value);
+        }
+        default:
+            return field.value;
+    }
+}
+}
+
+ContextFrame::ContextFrame(std::shared_ptr<const ContextFrame> parent, std::vector<ContextField> fields) {
+    if (parent) {
+        fields_ = parent->fields();
+    }
+    for (auto& field : fields) {
+        const auto it = std::find_if(fields_.begin(), fields_.end(),
+                                     [&](const ContextField& f) { return f.key == field.key; });
+        if (it != fields_.end()) {
+            *it = std::move(field);
+        } else {
+            fields_.push_back(std::move(field));
+        }
+    }
+
+    nlohmann::json j = nlohmann::json::object();
+    for (const auto& field : fields_) {
+        if (!text_.empty()) {
+            text_.push_back(' ');
+        }
+        text_.append(field.key).append("=").append(field.value);
+        j[field.key] = to_json(field);
+    }
+    json_ = j.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+ContextPtr DawgLog::current_context() {
+    return current;
+}
+
+ScopedContext::ScopedContext(std::initializer_list<ContextField> fields) : previous_(current) {
+    current = std::make_shared<const ContextFrame>(previous_, std::vector<ContextField>(fields));
+}
+
+ScopedContext::ScopedContext(ContextPtr captured) : previous_(current) {
+    current = std::move(captured);
+}
+
+ScopedContext::~ScopedContext() {
+    current = std::move(previous_);
+}
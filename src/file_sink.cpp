@@ -15,6 +15,22 @@ void FileSink::write(const Record& r, std::string_view formatted) {
     if (!out_.is_open()) {
         return;
     }
-    out_ << formatted << '\n';
+    out_ << formatted;
+    // Large writes bypass the stream buffer (one writev of buffer and payload), so the payload is not copied
+    out_.write(r.payload.data(), static_cast<std::streamsize>(r.payload.size()));
+    out_ << '\n';
+    out_.flush();
+}
+
+void FileSink::write_batch(std::span<const SinkEntry> entries) {
+    std::lock_guard lock(m_);
+    if (!out_.is_open()) {
+        return;
+    }
+    for (const auto& entry : entries) {
+        out_ << entry.formatted;
+        out_.write(entry.rec->payload.data(), static_cast<std::streamsize>(entry.rec->payload.size()));
+        out_ << '\n';
+    }
     out_.flush();
 }
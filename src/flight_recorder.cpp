@@ -0,0 +1,184 @@
+#include "dawg-log/flight_recorder.hpp"
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <type_traits>
+#include <fmt/args.h>
+#include <fmt/format.h>
+
+using namespace DawgLog;
+
+namespace {
+std::atomic<std::uint64_t> next_generation{1};
+
+struct LocalRing {
+    std::shared_ptr<void> ring;
+    std::uint64_t generation{0};
+};
+
+thread_local LocalRing local;
+}
+
+// Copies an argument into the slot if it has a raw representation; returns false otherwise
+struct FlightRecorder::ArgStore {
+    Slot& slot;
+
+    template<typename T>
+    bool operator()(T value) const {
+        Arg& arg = slot.args[slot.nargs];
+        if constexpr (std::is_same_v<T, bool>) {
+            arg.kind = ArgKind::BOOL;
+            arg.b = value;
+        } else if constexpr (std::is_same_v<T, char>) {
+            arg.kind = ArgKind::CHAR;
+            arg.c = value;
+        } else if constexpr (std::is_same_v<T, float>) {
+            arg.kind = ArgKind::F32;
+            arg.f = value;
+        } else if constexpr (std::is_same_v<T, double>) {
+            arg.kind = ArgKind::F64;
+            arg.d = value;
+        } else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, long long>) {
+            arg.kind = ArgKind::I64;
+            arg.i = value;
+        } else if constexpr (std::is_same_v<T, unsigned> || std::is_same_v<T, unsigned long long>) {
+            arg.kind = ArgKind::U64;
+            arg.u = value;
+        } else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, fmt::string_view>) {
+            const fmt::string_view sv{value};
+            arg.kind = ArgKind::STR;
+            arg.offset = slot.text.size();
+            arg.size = sv.size();
+            slot.text.append(sv.data(), sv.size());
+        } else if constexpr (std::is_same_v<T, const void*>) {
+            arg.kind = ArgKind::PTR;
+            arg.p = value;
+        } else {
+            // long double, 128-bit integers and user-defined types
+            return false;
+        }
+        ++slot.nargs;
+        return true;
+    }
+};
+
+FlightRecorder::FlightRecorder(Options options)
+    : options_(options), generation_(next_generation.fetch_add(1)) {
+    options_.capacity = std::max<std::size_t>(options_.capacity, 1);
+}
+
+FlightRecorder::Ring& FlightRecorder::local_ring() {
+    if (local.generation != generation_) {
+        auto ring = std::make_shared<Ring>(options_.capacity);
+        {
+            std::lock_guard lock(rings_m_);
+            rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                        [](const std::weak_ptr<Ring>& r) { return r.expired(); }),
+                         rings_.end());
+            rings_.push_back(ring);
+        }
+        local.ring = ring;
+        local.generation = generation_;
+    }
+    return *static_cast<Ring*>(local.ring.get());
+}
+
+void FlightRecorder::vcapture(LogLevel lvl, const Tag& tag, const SourceLocation& src,
+                              fmt::string_view fmt_str, fmt::format_args args) {
+    Ring& ring = local_ring();
+    std::lock_guard lock(ring.m);
+    Slot& slot = ring.claim();
+    slot.level = lvl;
+    slot.src = src;
+    slot.time = std::chrono::system_clock::now();
+    slot.mono_ns = monotonic_ns();
+    slot.cpu = current_cpu();
+    slot.context = current_context();
+    slot.tag = tag;
+    slot.text.clear();
+    slot.nargs = 0;
+    slot.preformatted = false;
+    for (int i = 0;; ++i) {
+        const auto arg = args.get(i);
+        if (!arg) {
+            break;
+        }
+        if (slot.nargs == kMaxArgs || !fmt::visit_format_arg(ArgStore{slot}, arg)) {
+            slot.preformatted = true;
+            break;
+        }
+    }
+    if (!slot.preformatted) {
+        slot.fmt.assign(fmt_str.data(), fmt_str.size());
+        return;
+    }
+    slot.fmt.clear();
+    slot.text.clear();
+    slot.nargs = 0;
+    try {
+        fmt::vformat_to(std::back_inserter(slot.text), fmt_str, args);
+    } catch (const std::exception& e) {
+        slot.text.assign(e.what());
+    }
+}
+
+std::string FlightRecorder::render(const Slot& slot) {
+    if (slot.preformatted) {
+        return slot.text;
+    }
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    for (std::size_t i = 0; i < slot.nargs; ++i) {
+        const Arg& arg = slot.args[i];
+        switch (arg.kind) {
+            case ArgKind::I64: store.push_back(arg.i); break;
+            case ArgKind::U64: store.push_back(arg.u); break;
+            case ArgKind::F32: store.push_back(arg.f); break;
+            case ArgKind::F64: store.push_back(arg.d); break;
+            case ArgKind::BOOL: store.push_back(arg.b); break;
+            case ArgKind::CHAR: store.push_back(arg.c); break;
+            case ArgKind::PTR: store.push_back(arg.p); break;
+            case ArgKind::STR: store.push_back(std::string_view(slot.text).substr(arg.offset, arg.size)); break;
+        }
+    }
+    try {
+        return fmt::vformat(slot.fmt, store);
+    } catch (const std::exception& e) {
+        return e.what();
+    }
+}
+
+std::vector<Record> FlightRecorder::drain(std::string_view app_name) {
+    std::vector<std::shared_ptr<Ring>> rings;
+    if (options_.all_threads) {
+        std::lock_guard lock(rings_m_);
+        for (const auto& weak : rings_) {
+            if (auto ring = weak.lock()) {
+                rings.push_back(std::move(ring));
+            }
+        }
+    } else if (local.generation == generation_) {
+        rings.push_back(std::static_pointer_cast<Ring>(local.ring));
+    }
+
+    std::vector<Record> records;
+    for (const auto& ring : rings) {
+        std::lock_guard lock(ring->m);
+        const auto size = ring->slots.size();
+        const auto first = (ring->next + size - ring->count) % size;
+        for (std::size_t i = 0; i < ring->count; ++i) {
+            const Slot& slot = ring->slots[(first + i) % size];
+            auto& rec = records.emplace_back(slot.level, slot.tag, slot.src, app_name, render(slot), slot.time);
+            rec.thread_id = ring->thread.id;
+            rec.thread_name = ring->thread.name;
+            rec.cpu = slot.cpu;
+            rec.mono_ns = slot.mono_ns;
+            rec.context = slot.context;
+        }
+        ring->count = 0;
+    }
+    if (rings.size() > 1) {
+        std::stable_sort(records.begin(), records.end(),
+                         [](const Record& a, const Record& b) { return a.mono_ns < b.mono_ns; });
+    }
+    return records;
+}
@@ -0,0 +1,210 @@
+#include "dawg-log/sinks/journald_sink.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace DawgLog;
+
+namespace {
+// Payloads from this size on skip the datagram attempt; journald rejects large datagrams anyway
+constexpr std::size_t kMemfdPayloadBytes = 64 * 1024;
+
+// Collects the iovecs of one journal entry; owns the strings the iovecs point into
+class Entry {
+public:
+    void add(std::string_view key, std::string_view value, bool binary = false) {
+        if (!binary && value.find('\n') == std::string_view::npos) {
+            push(key);
+            push("=");
+            push(value);
+            push("\n");
+            return;
+        }
+        // Binary form: KEY\n, little-endian 64-bit length, value, \n
+        push(key);
+        push("\n");
+        auto& len = storage_.emplace_back(8, '\0');
+        std::uint64_t size = value.size();
+        for (int i = 0; i < 8; ++i) {
+            len[static_cast<std::size_t>(i)] = static_cast<char>(size >> (8 * i) & 0xff);
+        }
+        push(len);
+        push(value);
+        push("\n");
+    }
+
+    std::string_view keep(std::string value) {
+        return storage_.emplace_back(std::move(value));
+    }
+
+    [[nodiscard]] const std::vector<iovec>& iov() const { return iov_; }
+
+private:
+    void push(std::string_view part) {
+        iov_.push_back({const_cast<char*>(part.data()), part.size()});
+    }
+
+    std::deque<std::string> storage_;
+    std::vector<iovec> iov_;
+};
+
+// Journal field names: upper-case letters, digits and underscores, not starting with '_' or a digit
+std::string field_name(std::string_view key) {
+    std::string name;
+    for (const char c : key) {
+        if (c >= 'a' && c <= 'z') {
+            name.push_back(static_cast<char>(c - 'a' + 'A'));
+        } else if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+            name.push_back(c);
+        } else {
+            name.push_back('_');
+        }
+    }
+    if (name.empty() || name[0] == '_' || (name[0] >= '0' && name[0] <= '9')) {
+        name.insert(0, "CTX_");
+    }
+    return name;
+}
+
+Entry make_entry(const Record& r, std::string_view identifier) {
+    Entry entry;
+    entry.add("MESSAGE", r.message);
+    entry.add("PRIORITY", entry.keep(std::to_string(to_syslog_level(r.level))));
+    entry.add("SYSLOG_IDENTIFIER", identifier);
+    entry.add("DAWGLOG_TAG", r.tag);
+    entry.add("CODE_FILE", r.src.file != nullptr ? r.src.file : "");
+    entry.add("CODE_LINE", entry.keep(std::to_string(r.src.line)));
+    entry.add("CODE_FUNC", r.src.func != nullptr ? r.src.func : "");
+    entry.add("TID", entry.keep(std::to_string(r.thread_id)));
+    if (r.context) {
+        for (const auto& field : r.context->fields()) {
+            entry.add(entry.keep(field_name(field.key)), field.value);
+        }
+    }
+    if (!r.payload.empty()) {
+        // Arbitrary bytes; the iovec points into the caller's buffer
+        entry.add("PAYLOAD", r.payload, true);
+    }
+    return entry;
+}
+
+sockaddr_un socket_address(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return addr;
+}
+}
+
+JournaldSink::JournaldSink(std::string identifier, std::string socket_path)
+    : identifier_(std::move(identifier)), socket_path_(std::move(socket_path)) {
+    fd_ = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open journal socket: " << std::strerror(errno) << std::endl;
+    }
+}
+
+JournaldSink::~JournaldSink() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void JournaldSink::write(const Record& r, std::string_view) {
+    if (fd_ < 0) {
+        return;
+    }
+    const auto entry = make_entry(r, identifier_);
+    if (r.payload.size() >= kMemfdPayloadBytes) {
+        send_memfd(entry.iov());
+    } else if (!send_datagram(entry.iov()) && (errno == EMSGSIZE || errno == ENOBUFS)) {
+        send_memfd(entry.iov());
+    }
+}
+
+void JournaldSink::write_batch(std::span<const SinkEntry> entries) {
+    if (fd_ < 0 || entries.empty()) {
+        return;
+    }
+    std::vector<Entry> built;
+    built.reserve(entries.size());
+    for (const auto& entry : entries) {
+        built.push_back(make_entry(*entry.rec, identifier_));
+    }
+    auto addr = socket_address(socket_path_);
+    std::vector<mmsghdr> msgs(built.size());
+    for (std::size_t i = 0; i < built.size(); ++i) {
+        auto& msg = msgs[i].msg_hdr;
+        msg.msg_name = &addr;
+        msg.msg_namelen = sizeof(addr);
+        msg.msg_iov = const_cast<iovec*>(built[i].iov().data());
+        msg.msg_iovlen = built[i].iov().size();
+    }
+    // One system call for the whole batch; an entry the socket rejects goes alone (or via memfd)
+    std::size_t sent = 0;
+    while (sent < msgs.size()) {
+        const int n = ::sendmmsg(fd_, msgs.data() + sent, static_cast<unsigned>(msgs.size() - sent), MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<std::size_t>(n);
+            continue;
+        }
+        if (errno == EMSGSIZE || errno == ENOBUFS) {
+            send_memfd(built[sent].iov());
+        }
+        ++sent;
+    }
+}
+
+bool JournaldSink::send_datagram(const std::vector<iovec>& iov) {
+    auto addr = socket_address(socket_path_);
+    msghdr msg{};
+    msg.msg_name = &addr;
+    msg.msg_namelen = sizeof(addr);
+    msg.msg_iov = const_cast<iovec*>(iov.data());
+    msg.msg_iovlen = iov.size();
+    return ::sendmsg(fd_, &msg, MSG_NOSIGNAL) >= 0;
+}
+
+bool JournaldSink::send_memfd(const std::vector<iovec>& iov) {
+    const int mfd = ::memfd_create("dawglog-journal", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (mfd < 0) {
+        return false;
+    }
+    bool ok = true;
+    for (const auto& part : iov) {
+        const char* data = static_cast<const char*>(part.iov_base);
+        std::size_t left = part.iov_len;
+        while (ok && left > 0) {
+            const auto n = ::write(mfd, data, left);
+            ok = n > 0;
+            data += n > 0 ? n : 0;
+            left -= n > 0 ? static_cast<std::size_t>(n) : 0;
+        }
+    }
+    // journald only accepts sealed memfds
+    ok = ok && ::fcntl(mfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == 0;
+    if (ok) {
+        auto addr = socket_address(socket_path_);
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        msghdr msg{};
+        msg.msg_name = &addr;
+        msg.msg_namelen = sizeof(addr);
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg), &mfd, sizeof(int));
+        ok = ::sendmsg(fd_, &msg, MSG_NOSIGNAL) >= 0;
+    }
+    ::close(mfd);
+    return ok;
+}
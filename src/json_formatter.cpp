@@ -10,6 +10,26 @@ std::string JsonFormatter::format(const Record& r) {
     j["level"] = std::string(to_string(r.level));
     j["tag"] = r.tag;
     j["message"] = r.message;
+    if (thread_fields_) {
+        j["tid"] = r.thread_id;
+        if (!r.thread_name.empty()) {
+            j["thread"] = r.thread_name;
+        }
+        j["cpu"] = r.cpu;
+        j["mono_ns"] = r.mono_ns;
+    }
+    if (r.span_ns != 0) {
+        j["span_ns"] = r.span_ns;
+    }
+    if (!r.payload.empty()) {
+        j["payload"] = r.payload;
+    }
 
-    return j.dump();
+    // Payloads may be arbitrary bytes; invalid UTF-8 is replaced rather than thrown on
+    auto out = j.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+    if (r.context) {
+        // Splice the fragment serialized when the scope was entered
+        out.insert(out.size() - 1, ",\"context\":" + r.context->json());
+    }
+    return out;
 }
\ No newline at end of file
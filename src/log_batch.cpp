@@ -0,0 +1,48 @@
+#include "dawg-log/log_batch.hpp"
+#include <iterator>
+#include <utility>
+
+using namespace DawgLog;
+
+namespace {
+// Record buffer kept per thread, so a batch in a loop does not allocate it again
+thread_local std::vector<Record> spare_records;
+}
+
+LogBatch::LogBatch(Logger& logger, const Tag& tag, std::size_t auto_commit)
+    : logger_(&logger), tag_(tag), auto_commit_(auto_commit), records_(std::exchange(spare_records, {})) {
+}
+
+LogBatch::LogBatch(LogBatch&& other) noexcept
+    : logger_(other.logger_), tag_(other.tag_), auto_commit_(other.auto_commit_),
+      records_(std::move(other.records_)) {
+    other.records_.clear();
+}
+
+LogBatch::~LogBatch() {
+    commit();
+    if (records_.capacity() > spare_records.capacity()) {
+        spare_records = std::move(records_);
+    }
+}
+
+void LogBatch::vadd(LogLevel lvl, const SourceLocation& src, fmt::string_view fmt_str, fmt::format_args args) {
+    if (!logger_->enabled(lvl, tag_.id)) {
+        // Only captured by the flight recorder, like a suppressed Logger::log() call
+        logger_->vlog(lvl, tag_, src, fmt_str, args);
+        return;
+    }
+    auto& rec = records_.emplace_back(lvl, tag_, src, logger_->app_name(), std::string_view{});
+    fmt::vformat_to(std::back_inserter(rec.message), fmt_str, args);
+    if (auto_commit_ > 0 && records_.size() >= auto_commit_) {
+        commit();
+    }
+}
+
+void LogBatch::commit() {
+    if (records_.empty()) {
+        return;
+    }
+    logger_->write_batch(records_);
+    records_.clear();
+}
@@ -0,0 +1,62 @@
+#include "dawg-log/log_site.hpp"
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace DawgLog;
+
+namespace {
+struct SiteRule {
+    std::string file;
+    int line;
+    bool enabled;
+};
+
+struct SiteRegistry {
+    std::mutex m;
+    std::vector<LogSite*> sites;
+    std::vector<SiteRule> rules;
+};
+
+SiteRegistry& registry() {
+    static SiteRegistry instance;
+    return instance;
+}
+
+bool matches(const SiteRule& rule, const LogSite& site) {
+    const std::string_view file = site.file();
+    const bool file_matches = file.size() >= rule.file.size() &&
+                              file.compare(file.size() - rule.file.size(), rule.file.size(), rule.file) == 0;
+    return file_matches && (rule.line == 0 || rule.line == site.line());
+}
+}
+
+std::uint8_t LogSite::register_site() {
+    auto& reg = registry();
+    std::lock_guard lock(reg.m);
+    const auto current = state_.load(std::memory_order_relaxed);
+    if (current != kUnregistered) {
+        return current;
+    }
+    bool enabled = true;
+    for (const auto& rule : reg.rules) {
+        if (matches(rule, *this)) {
+            enabled = rule.enabled;
+        }
+    }
+    reg.sites.push_back(this);
+    const auto state = enabled ? kEnabled : kDisabled;
+    state_.store(state, std::memory_order_relaxed);
+    return state;
+}
+
+void DawgLog::set_log_site_enabled(std::string_view file, int line, bool enabled) {
+    auto& reg = registry();
+    std::lock_guard lock(reg.m);
+    reg.rules.push_back(SiteRule{std::string(file), line, enabled});
+    for (auto* site : reg.sites) {
+        if (matches(reg.rules.back(), *site)) {
+            site->set_enabled(enabled);
+        }
+    }
+}
@@ -1,103 +1,403 @@
 #include "dawg-log/base_logger.hpp"
 #include "dawg-log/concepts.hpp"
 #include "dawg-log/general_logs.hpp"
+#include "dawg-log/log_batch.hpp"
 #include "dawg-log/sinks/console_sink.hpp"
 #include "dawg-log/sinks/syslog_sink.hpp"
 #include "dawg-log/sinks/file_sink.hpp"
+#include "dawg-log/sinks/archive_sink.hpp"
+#include "dawg-log/sinks/network_sink.hpp"
+#include "dawg-log/sinks/shm_sink.hpp"
+#include "dawg-log/sinks/journald_sink.hpp"
+#include "dawg-log/sinks/sharded_file_sink.hpp"
+#include "dawg-log/sinks/trace_file_sink.hpp"
+#ifdef DAWGLOG_HAS_ZLIB
+#include "dawg-log/sinks/compressed_file_sink.hpp"
+#endif
 #include "dawg-log/formatters/text_formatter.hpp"
 #include "dawg-log/formatters/json_formatter.hpp"
+#include "dawg-log/formatters/trace_event_formatter.hpp"
+#include <algorithm>
+#include <deque>
+#include <optional>
 
 using namespace DawgLog;
 
 namespace {
 std::unique_ptr<Logger> logger;
 
-FormatterPtr make_formatter(const FormatterType type) {
+FormatterPtr make_formatter(const FormatterType type, bool thread_fields = false) {
     switch (type) {
         case FormatterType::JSON:
-            return std::make_unique<JsonFormatter>();
+            return std::make_unique<JsonFormatter>(thread_fields);
+        case FormatterType::TRACE:
+            return std::make_unique<TraceEventFormatter>();
         default:
-            return std::make_unique<TextFormatter>();
+            return std::make_unique<TextFormatter>(thread_fields);
     }
 }
 
-SinkPtr make_sink(const SinkType type, const std::string& app_name, const std::string& file_path) {
-    switch (type) {
+// `backend` places the background threads of sinks that have one (network, compressed file)
+SinkPtr make_sink(const Config::TargetConfig& target, const std::string& app_name, const BackendOptions& backend = {}) {
+    switch (target.sink) {
         case SinkType::SYSLOG:
-            return std::make_unique<SyslogSink>(app_name);
+            return std::make_unique<SyslogSink>(app_name, target.syslog_max_bytes);
         case SinkType::FILE:
-            return std::make_unique<FileSink>(file_path);
+            return std::make_unique<FileSink>(target.file_path);
+        case SinkType::COMPRESSED_FILE:
+#ifdef DAWGLOG_HAS_ZLIB
+            return std::make_unique<CompressedFileSink>(target.file_path, target.frame_bytes,
+                                                        std::chrono::seconds(1), backend);
+#else
+            std::cerr << "Built without zlib, 'compressed_file' falls back to 'file'." << std::endl;
+            return std::make_unique<FileSink>(target.file_path);
+#endif
+        case SinkType::ARCHIVE:
+            return std::make_unique<ArchiveSink>(target.file_path, target.block_bytes);
+        case SinkType::SHM:
+            return std::make_unique<ShmSink>(target.shm_name, app_name, target.shm_slots, target.shm_slot_bytes);
+        case SinkType::TRACE:
+            return std::make_unique<TraceFileSink>(target.file_path);
+        case SinkType::SHARDED_FILE:
+            return std::make_unique<ShardedFileSink>(target.file_path, target.shard_buffer_bytes);
+        case SinkType::JOURNALD:
+            return std::make_unique<JournaldSink>(app_name, target.journal_socket);
+        case SinkType::NETWORK: {
+            NetworkSink::Options options;
+            options.host = target.host;
+            options.port = target.port;
+            options.protocol = target.protocol == "udp" ? NetworkSink::Protocol::UDP : NetworkSink::Protocol::TCP;
+            options.framing = target.framing == "octet_counting"
+                                  ? NetworkSink::Framing::OCTET_COUNTING
+                                  : NetworkSink::Framing::NEWLINE;
+            options.spool_path = target.spool_path;
+            options.spool_max_bytes = target.spool_max_bytes;
+            options.max_batch = target.max_batch;
+            options.udp_batch = target.udp_batch;
+            options.queue_max_bytes = target.send_queue_bytes;
+            options.backend = backend;
+            return std::make_unique<NetworkSink>(std::move(options));
+        }
         default:
             return std::make_unique<ConsoleSink>(app_name);
     }
 }
 
-Logger::Target make_target(SinkType sink_type,
-                           FormatterType formatter_type,
-                           const std::string& app_name,
-                           const std::string& file_path) {
-    return Logger::Target{make_sink(sink_type, app_name, file_path), make_formatter(formatter_type)};
+Config::TargetConfig primary_target(const Config& cfg) {
+    Config::TargetConfig target = cfg.sink_options;
+    target.sink = cfg.sink;
+    target.format = cfg.format;
+    target.file_path = cfg.file_path;
+    return target;
+}
+
+Logger::Target make_target(const Config::TargetConfig& target, const std::string& app_name,
+                           const BackendOptions& backend = {}, std::shared_ptr<MemoryBudget> budget = nullptr) {
+    Logger::Target result{make_sink(target, app_name, backend), make_formatter(target.format, target.thread_fields)};
+    result.filter = TargetFilter(target.filter);
+    if (target.queue) {
+        auto options = *target.queue;
+        options.backend = backend;
+        options.budget = std::move(budget);
+        result.queue = std::make_unique<TargetQueue>(*result.sink, options, result.formatter.get());
+    }
+    return result;
+}
+
+// Change the sink or formatter of a target; its queue (if any) is drained and restarted around the change.
+template<typename Change>
+void change_target(Logger::Target& target, Change change) {
+    std::optional<TargetQueue::Options> queue;
+    if (target.queue) {
+        queue = target.queue->options();
+        target.queue.reset();
+    }
+    change(target);
+    if (queue && target.sink) {
+        target.queue = std::make_unique<TargetQueue>(*target.sink, *queue, target.formatter.get());
+    }
+}
+
+// Format a record for a target unless its sink ignores the text or its queue formats it.
+// Sets `strip` if the payload must not reach the sink or queue (it is in the text, or unused).
+// A queue that formats records keeps the payload: its format workers append it to the text.
+std::string format_for(Logger::Target& target, const Record& rec, bool& strip) {
+    const bool queue_formats = target.queue && target.queue->formats_records();
+    bool sink_writes_payload = target.sink->writes_payload();
+    std::string formatted;
+    if (target.sink->needs_formatting() && !queue_formats) {
+        formatted = format_for_sink(*target.formatter, *target.sink, rec, sink_writes_payload);
+    }
+    strip = !rec.payload.empty() && !sink_writes_payload && !queue_formats &&
+            (target.sink->writes_payload() || target.queue);
+    return formatted;
+}
+
+Record without_payload(const Record& rec) {
+    Record copy(rec);
+    copy.payload = {};
+    return copy;
 }
 
 std::vector<Logger::Target> make_targets_from_config(const Config& cfg) {
     std::vector<Logger::Target> targets;
     if (!cfg.targets.empty()) {
+        const auto budget = cfg.memory_budget ? std::make_shared<MemoryBudget>(*cfg.memory_budget) : nullptr;
         targets.reserve(cfg.targets.size());
         for (const auto& target : cfg.targets) {
-            targets.emplace_back(make_target(target.sink, target.format, cfg.app_name, target.file_path));
+            targets.emplace_back(make_target(target, cfg.app_name, cfg.backend, budget));
         }
         return targets;
     }
-    targets.emplace_back(make_target(cfg.sink, cfg.format, cfg.app_name, cfg.file_path));
+    targets.emplace_back(make_target(primary_target(cfg), cfg.app_name, cfg.backend));
     return targets;
 }
+
+// The budget shared by the target queues; the logger reports what it shed
+std::shared_ptr<MemoryBudget> find_budget(const std::vector<Logger::Target>& targets) {
+    for (const auto& target : targets) {
+        if (target.queue && target.queue->options().budget) {
+            return target.queue->options().budget;
+        }
+    }
+    return nullptr;
+}
 }
 
 Logger::Logger(std::vector<Target> targets, std::string app_name)
-    : targets_(std::move(targets)), app_name_(std::move(app_name)) {}
+    : targets_(std::move(targets)), app_name_(std::move(app_name)), budget_(find_budget(targets_)) {}
 
 void Logger::init(const Config& cfg) {
-    logger = std::make_unique<Logger>(make_targets_from_config(cfg), cfg.app_name);
+    init(cfg, make_targets_from_config(cfg));
 }
 
 void Logger::init(const Config& cfg, FormatterPtr formatter) {
     std::vector<Target> targets;
-    targets.emplace_back(Target{make_sink(cfg.sink, cfg.app_name, cfg.file_path), std::move(formatter)});
-    logger = std::make_unique<Logger>(std::move(targets), cfg.app_name);
+    targets.emplace_back(Target{make_sink(primary_target(cfg), cfg.app_name, cfg.backend), std::move(formatter)});
+    init(cfg, std::move(targets));
 }
 
 void Logger::init(const Config& cfg, SinkPtr sink) {
     std::vector<Target> targets;
     targets.emplace_back(Target{std::move(sink), make_formatter(cfg.format)});
-    logger = std::make_unique<Logger>(std::move(targets), cfg.app_name);
+    init(cfg, std::move(targets));
 }
 
 void Logger::init(const Config& cfg, SinkPtr sink, FormatterPtr formatter) {
     std::vector<Target> targets;
     targets.emplace_back(Target{std::move(sink), std::move(formatter)});
-    logger = std::make_unique<Logger>(std::move(targets), cfg.app_name);
+    init(cfg, std::move(targets));
 }
 
 void Logger::init(const Config& cfg, std::vector<Target> targets) {
-    logger = std::make_unique<Logger>(std::move(targets), cfg.app_name);
+    auto configured = std::make_unique<Logger>(std::move(targets), cfg.app_name);
+    configured->apply_config(cfg);
+    logger = std::move(configured);
+    bump_epoch();
+}
+
+void Logger::apply_config(const Config& cfg) {
+    level_.store(cfg.level, std::memory_order_relaxed);
+    TagRegistry::clear_levels();
+    for (const auto& [tag, lvl] : cfg.tag_levels) {
+        TagRegistry::set_level(TagRegistry::intern(tag).id, lvl);
+    }
+    if (cfg.flight_recorder.enabled) {
+        recorder_ = std::make_unique<FlightRecorder>(FlightRecorder::Options{
+            cfg.flight_recorder.capacity, cfg.flight_recorder.dump_level, cfg.flight_recorder.all_threads});
+    }
+}
+
+void Logger::write_locked(const Record& rec) {
+    for (auto& target : targets_) {
+        if (!target.sink || !target.formatter || !target.filter.accepts(rec)) {
+            continue;
+        }
+        bool strip = false;
+        auto formatted = format_for(target, rec, strip);
+        std::optional<Record> stripped;
+        if (strip) {
+            stripped = without_payload(rec);
+        }
+        const auto& out = stripped ? *stripped : rec;
+        if (target.queue) {
+            target.queue->push(out, std::move(formatted));
+        } else {
+            target.sink->write(out, formatted);
+        }
+    }
+}
+
+void Logger::write_batch_locked(std::span<const Record> records) {
+    std::vector<const Record*> accepted;
+    std::vector<std::string> formatted;
+    std::vector<SinkEntry> entries;
+    std::deque<Record> stripped;
+    for (auto& target : targets_) {
+        if (!target.sink || !target.formatter) {
+            continue;
+        }
+        accepted.clear();
+        for (const auto& rec : records) {
+            if (target.filter.accepts(rec)) {
+                accepted.push_back(&rec);
+            }
+        }
+        if (accepted.empty()) {
+            continue;
+        }
+        formatted.clear();
+        for (auto& rec : accepted) {
+            bool strip = false;
+            formatted.push_back(format_for(target, *rec, strip));
+            if (strip) {
+                rec = &stripped.emplace_back(without_payload(*rec));
+            }
+        }
+        entries.clear();
+        for (std::size_t i = 0; i < accepted.size(); ++i) {
+            entries.push_back(SinkEntry{accepted[i], formatted[i]});
+        }
+        if (target.queue) {
+            target.queue->push_batch(entries);
+        } else {
+            target.sink->write_batch(entries);
+        }
+    }
+}
+
+void Logger::report_shedding_locked() {
+    if (!budget_) {
+        return;
+    }
+    if (auto report = budget_->take_report()) {
+        // Written at error level so the report itself may use the emergency reserve
+        write_locked(Record{LogLevel::error, "LoadShedding", LOG_SRC, app_name_, *report});
+    }
+}
+
+void Logger::write_flight_recorder_locked() {
+    const auto records = recorder_->drain(app_name_);
+    if (records.empty()) {
+        return;
+    }
+    write_locked(Record{LogLevel::notice, "FlightRecorder", LOG_SRC, app_name_,
+                        fmt::format("dumping {} suppressed records", records.size())});
+    for (const auto& rec : records) {
+        write_locked(rec);
+    }
+}
+
+std::string Logger::vlog(LogLevel lvl, const Tag& tag, const SourceLocation& src,
+                         fmt::string_view fmt_str, fmt::format_args args) {
+    if (!enabled(lvl, tag.id)) {
+        if (recorder_) {
+            recorder_->vcapture(lvl, tag, src, fmt_str, args);
+        }
+        return {};
+    }
+    std::string msg = fmt::vformat(fmt_str, args);
+    std::lock_guard<std::mutex> lock(m_);
+    write_message_locked(lvl, tag, src, msg, {});
+    return msg;
+}
+
+void Logger::vlog_payload(LogLevel lvl, const Tag& tag, const SourceLocation& src, std::string_view payload,
+                          fmt::string_view fmt_str, fmt::format_args args) {
+    const std::string msg = fmt::vformat(fmt_str, args);
+    std::lock_guard<std::mutex> lock(m_);
+    write_message_locked(lvl, tag, src, msg, payload);
+}
+
+void Logger::write_message_locked(LogLevel lvl, const Tag& tag, const SourceLocation& src, std::string_view msg,
+                                  std::string_view payload) {
+    report_shedding_locked();
+    if (recorder_ && lvl >= recorder_->options().dump_level) {
+        write_flight_recorder_locked();
+    }
+    // Targets copy what they keep (queues into their own resource), so the arena is free again afterwards
+    auto& arena = RecordArena::local();
+    {
+        Record rec{lvl, tag, src, app_name_, msg, arena.resource()};
+        rec.payload = payload;
+        write_locked(rec);
+    }
+    arena.reset();
+}
+
+void Logger::write(const Record& rec) {
+    std::lock_guard<std::mutex> lock(m_);
+    report_shedding_locked();
+    write_locked(rec);
+}
+
+void Logger::write_batch(std::span<const Record> records) {
+    std::lock_guard<std::mutex> lock(m_);
+    report_shedding_locked();
+    if (recorder_) {
+        const auto dump_level = recorder_->options().dump_level;
+        if (std::any_of(records.begin(), records.end(), [&](const Record& r) { return r.level >= dump_level; })) {
+            write_flight_recorder_locked();
+        }
+    }
+    write_batch_locked(records);
+}
+
+void Logger::span(LogLevel lvl, const Tag& tag, const SourceLocation& src, std::string_view name,
+                  std::uint64_t start_ns, std::uint64_t end_ns) {
+    if (!enabled(lvl, tag.id)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_);
+    report_shedding_locked();
+    auto& arena = RecordArena::local();
+    {
+        auto rec = Record{lvl, tag, src, app_name_, name, arena.resource()};
+        rec.mono_ns = end_ns;
+        rec.span_ns = end_ns - start_ns;
+        write_locked(rec);
+    }
+    arena.reset();
+}
+
+LogBatch Logger::batch(const Tag& tag) {
+    return LogBatch(*this, tag);
+}
+
+LogBatch Logger::batch() {
+    return batch(general_tag());
+}
+
+void Logger::flush_flight_recorder() {
+    if (!recorder_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_);
+    write_flight_recorder_locked();
 }
 
 Logger& Logger::instance() {
     if (!logger) {
         std::vector<Target> targets;
-        targets.emplace_back(make_target(SinkType::CONSOLE, FormatterType::TEXT, "DawgLog", "dawglog.log"));
+        targets.emplace_back(make_target(Config::TargetConfig{}, "DawgLog"));
         logger = std::make_unique<Logger>(std::move(targets), "DawgLog");
+        bump_epoch();
         WARNING("Logger not initialized. Defaulting to console sink and text format.");
     }
     return *logger;
 }
 
+void Logger::set_tag_level(std::string_view tag, std::optional<LogLevel> lvl) {
+    TagRegistry::set_level(TagRegistry::intern(tag).id, lvl);
+    bump_epoch();
+}
+
 void Logger::set_formatter(FormatterPtr fmt) {
     std::lock_guard<std::mutex> lock(m_);
     if (targets_.empty()) {
         return;
     }
-    targets_.front().formatter = std::move(fmt);
+    change_target(targets_.front(), [&fmt](Target& target) { target.formatter = std::move(fmt); });
 }
 
 void Logger::set_sink(SinkPtr sink) {
@@ -105,15 +405,25 @@ void Logger::set_sink(SinkPtr sink) {
     if (targets_.empty()) {
         return;
     }
-    targets_.front().sink = std::move(sink);
+    change_target(targets_.front(), [&sink](Target& target) { target.sink = std::move(sink); });
 }
 
 void Logger::set_targets(std::vector<Target> targets) {
     std::lock_guard<std::mutex> lock(m_);
     targets_ = std::move(targets);
+    budget_ = find_budget(targets_);
 }
 
 void Logger::add_target(SinkPtr sink, FormatterPtr formatter) {
     std::lock_guard<std::mutex> lock(m_);
     targets_.push_back(Target{std::move(sink), std::move(formatter)});
 }
+
+void Logger::flush() {
+    std::lock_guard<std::mutex> lock(m_);
+    for (auto& target : targets_) {
+        if (target.queue) {
+            target.queue->flush();
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "dawg-log/memory_budget.hpp"
+#include <fmt/format.h>
+
+using namespace DawgLog;
+
+MemoryBudget::MemoryBudget(Options options) : options_(options) {
+}
+
+std::size_t MemoryBudget::limit(LogLevel lvl) const {
+    const auto fraction = [this](double f) {
+        return static_cast<std::size_t>(static_cast<double>(options_.max_bytes) * f);
+    };
+    switch (lvl) {
+        case LogLevel::debug:
+            return fraction(options_.shed_debug);
+        case LogLevel::info:
+            return fraction(options_.shed_info);
+        case LogLevel::notice:
+            return fraction(options_.shed_notice);
+        case LogLevel::warning:
+            return options_.max_bytes;
+        default:
+            return options_.max_bytes + options_.reserve_bytes;
+    }
+}
+
+bool MemoryBudget::try_acquire(LogLevel lvl, std::size_t bytes) {
+    const auto max = limit(lvl);
+    auto used = used_.load(std::memory_order_relaxed);
+    do {
+        if (used + bytes > max) {
+            if (lvl >= LogLevel::error) {
+                // Never shed: overdraw the budget and leave a trace in the next report
+                overdrawn_.fetch_add(1, std::memory_order_relaxed);
+                used_.fetch_add(bytes, std::memory_order_relaxed);
+                return true;
+            }
+            shed_[static_cast<std::size_t>(lvl)].fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!used_.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+    return true;
+}
+
+void MemoryBudget::release(std::size_t bytes) {
+    used_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+std::uint64_t MemoryBudget::shed(LogLevel lvl) const {
+    return shed_[static_cast<std::size_t>(lvl)].load(std::memory_order_relaxed);
+}
+
+std::optional<std::string> MemoryBudget::take_report() {
+    const auto now = std::chrono::steady_clock::now();
+    if (last_report_ != std::chrono::steady_clock::time_point{} && now - last_report_ < options_.report_interval) {
+        return std::nullopt;
+    }
+    std::string counts;
+    for (std::size_t i = 0; i < kLogLevelCount; ++i) {
+        const auto total = shed_[i].load(std::memory_order_relaxed);
+        if (total == reported_[i]) {
+            continue;
+        }
+        if (!counts.empty()) {
+            counts += ", ";
+        }
+        counts += fmt::format("{} {}", total - reported_[i], to_string(static_cast<LogLevel>(i)));
+        reported_[i] = total;
+    }
+    const auto overdrawn = overdrawn_.load(std::memory_order_relaxed);
+    if (counts.empty() && overdrawn == reported_overdrawn_) {
+        return std::nullopt;
+    }
+    last_report_ = now;
+    std::string text = counts.empty() ? std::string() : fmt::format("shed {} records", counts);
+    if (overdrawn != reported_overdrawn_) {
+        text += fmt::format("{}kept {} error/critical records beyond the reserve", text.empty() ? "" : ", ",
+                            overdrawn - reported_overdrawn_);
+        reported_overdrawn_ = overdrawn;
+    }
+    return fmt::format("{} (memory budget {} bytes, {} in use)", text, options_.max_bytes, used());
+}
@@ -0,0 +1,42 @@
+#include "dawg-log/memory_resource.hpp"
+#include <atomic>
+
+using namespace DawgLog;
+
+namespace {
+std::atomic<std::pmr::memory_resource*> log_resource{nullptr};
+
+// Upstream of the record arenas; follows set_log_memory_resource() after the arenas were created
+class CurrentResource : public std::pmr::memory_resource {
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return log_memory_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        log_memory_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+CurrentResource current_resource;
+}
+
+void DawgLog::set_log_memory_resource(std::pmr::memory_resource* resource) {
+    log_resource.store(resource, std::memory_order_release);
+}
+
+std::pmr::memory_resource* DawgLog::log_memory_resource() {
+    auto* resource = log_resource.load(std::memory_order_acquire);
+    return resource != nullptr ? resource : std::pmr::new_delete_resource();
+}
+
+RecordArena::RecordArena() : arena_(buffer_, sizeof(buffer_), &current_resource) {
+}
+
+RecordArena& RecordArena::local() {
+    thread_local RecordArena arena;
+    return arena;
+}
@@ -0,0 +1,370 @@
+#include "dawg-log/sinks/network_sink.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using namespace DawgLog;
+
+namespace {
+constexpr std::size_t kMaxDatagram = 65000;
+constexpr auto kIdleWait = std::chrono::milliseconds(100);
+
+bool wait_writable(int fd, std::chrono::milliseconds timeout) {
+    pollfd pfd{fd, POLLOUT, 0};
+    return ::poll(&pfd, 1, static_cast<int>(timeout.count())) == 1 && (pfd.revents & POLLOUT) != 0;
+}
+
+int open_socket(const NetworkSink::Options& options) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = options.protocol == NetworkSink::Protocol::TCP ? SOCK_STREAM : SOCK_DGRAM;
+    addrinfo* res = nullptr;
+    const auto port = std::to_string(options.port);
+    if (::getaddrinfo(options.host.c_str(), port.c_str(), &hints, &res) != 0) {
+        return -1;
+    }
+    int fd = -1;
+    for (auto* ai = res; ai != nullptr; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        if (errno == EINPROGRESS && wait_writable(fd, options.connect_timeout)) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0) {
+                break;
+            }
+        }
+        ::close(fd);
+        fd = -1;
+    }
+    ::freeaddrinfo(res);
+    return fd;
+}
+}
+
+NetworkSink::NetworkSink(Options options)
+    : options_(std::move(options)), backoff_(options_.reconnect_min) {
+    options_.max_batch = std::clamp<std::size_t>(options_.max_batch, 1, IOV_MAX / 2);
+    if (!options_.spool_path.empty()) {
+        std::error_code ec;
+        spool_bytes_ = std::filesystem::exists(options_.spool_path, ec)
+                           ? std::filesystem::file_size(options_.spool_path, ec)
+                           : 0;
+    }
+    worker_ = std::thread([this] { run(); });
+}
+
+NetworkSink::~NetworkSink() {
+    {
+        std::lock_guard lock(m_);
+        stop_ = true;
+    }
+    work_cv_.notify_one();
+    worker_.join();
+    disconnect();
+}
+
+void NetworkSink::write(const Record&, std::string_view formatted) {
+    {
+        std::lock_guard lock(m_);
+        if (queue_bytes_ + formatted.size() > options_.queue_max_bytes) {
+            ++dropped_;
+            return;
+        }
+        queue_bytes_ += formatted.size();
+        queue_.emplace_back(formatted);
+    }
+    work_cv_.notify_one();
+}
+
+void NetworkSink::write_batch(std::span<const SinkEntry> entries) {
+    {
+        std::lock_guard lock(m_);
+        for (const auto& entry : entries) {
+            if (queue_bytes_ + entry.formatted.size() > options_.queue_max_bytes) {
+                ++dropped_;
+                continue;
+            }
+            queue_bytes_ += entry.formatted.size();
+            queue_.emplace_back(entry.formatted);
+        }
+    }
+    work_cv_.notify_one();
+}
+
+void NetworkSink::flush() {
+    std::unique_lock lock(m_);
+    while (!queue_.empty() || in_flight_) {
+        work_cv_.notify_one();
+        idle_cv_.wait_for(lock, kIdleWait);
+    }
+}
+
+std::uint64_t NetworkSink::dropped() const {
+    std::lock_guard lock(m_);
+    return dropped_;
+}
+
+bool NetworkSink::connected() const {
+    std::lock_guard lock(m_);
+    return connected_;
+}
+
+void NetworkSink::run() {
+    apply_backend_options(options_.backend);
+    std::unique_lock lock(m_);
+    while (true) {
+        if (queue_.empty() && (spool_bytes_ == 0 || stop_)) {
+            if (stop_) {
+                return;
+            }
+            work_cv_.wait_for(lock, kIdleWait);
+            continue;
+        }
+        std::vector<std::string> batch;
+        const auto count = std::min(queue_.size(), options_.max_batch);
+        for (std::size_t i = 0; i < count; ++i) {
+            queue_bytes_ -= queue_.front().size();
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        in_flight_ = true;
+        const bool stopping = stop_;
+        lock.unlock();
+
+        std::size_t sent = 0;
+        const bool up = ensure_connected() && replay_spool();
+        if (up) {
+            sent = send_batch(batch);
+        }
+        if (!up || sent < batch.size()) {
+            // Also when only the spool replay failed: retrying on the same socket would spin
+            if (fd_ >= 0) {
+                disconnect();
+                reconnect_later();
+            }
+            spool(std::span<const std::string>(batch).subspan(sent));
+        }
+
+        lock.lock();
+        connected_ = fd_ >= 0;
+        in_flight_ = false;
+        idle_cv_.notify_all();
+        if (!connected_ && !stopping) {
+            const auto wait = next_attempt_ - std::chrono::steady_clock::now();
+            if (wait > std::chrono::steady_clock::duration::zero() && queue_.empty()) {
+                work_cv_.wait_for(lock, std::min<std::chrono::steady_clock::duration>(wait, kIdleWait));
+            }
+        }
+    }
+}
+
+bool NetworkSink::ensure_connected() {
+    if (fd_ >= 0) {
+        return true;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now < next_attempt_) {
+        return false;
+    }
+    fd_ = open_socket(options_);
+    if (fd_ < 0) {
+        reconnect_later();
+        return false;
+    }
+    backoff_ = options_.reconnect_min;
+    return true;
+}
+
+void NetworkSink::reconnect_later() {
+    next_attempt_ = std::chrono::steady_clock::now() + backoff_;
+    backoff_ = std::min(backoff_ * 2, options_.reconnect_max);
+}
+
+void NetworkSink::disconnect() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+std::size_t NetworkSink::send_batch(const std::vector<std::string>& batch) {
+    if (batch.empty()) {
+        return 0;
+    }
+    return options_.protocol == Protocol::TCP ? send_stream(batch) : send_datagrams(batch);
+}
+
+std::size_t NetworkSink::send_stream(const std::vector<std::string>& batch) {
+    std::vector<std::string> prefixes;
+    std::vector<iovec> iov;
+    prefixes.reserve(batch.size());
+    iov.reserve(batch.size() * 2);
+    static char newline = '\n';
+    for (const auto& rec : batch) {
+        if (options_.framing == Framing::OCTET_COUNTING) {
+            prefixes.push_back(std::to_string(rec.size()) + ' ');
+            iov.push_back({prefixes.back().data(), prefixes.back().size()});
+            iov.push_back({const_cast<char*>(rec.data()), rec.size()});
+        } else {
+            iov.push_back({const_cast<char*>(rec.data()), rec.size()});
+            iov.push_back({&newline, 1});
+        }
+    }
+
+    std::size_t first = 0;
+    while (first < iov.size()) {
+        msghdr msg{};
+        msg.msg_iov = iov.data() + first;
+        msg.msg_iovlen = iov.size() - first;
+        const auto sent = ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_writable(fd_, options_.send_timeout)) {
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            // Two iovecs per record: only records with both parts written count as sent
+            return first / 2;
+        }
+        auto remaining = static_cast<std::size_t>(sent);
+        while (first < iov.size() && remaining >= iov[first].iov_len) {
+            remaining -= iov[first].iov_len;
+            ++first;
+        }
+        if (remaining > 0) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + remaining;
+            iov[first].iov_len -= remaining;
+        }
+    }
+    return batch.size();
+}
+
+std::size_t NetworkSink::send_datagrams(const std::vector<std::string>& batch) {
+    std::vector<std::string> packed;
+    // Number of records in the datagrams up to and including each one
+    std::vector<std::size_t> records_through;
+    if (options_.udp_batch) {
+        packed.emplace_back();
+        records_through.push_back(0);
+        for (const auto& rec : batch) {
+            if (!packed.back().empty() && packed.back().size() + rec.size() + 1 > kMaxDatagram) {
+                packed.emplace_back();
+                records_through.push_back(records_through.back());
+            }
+            ++records_through.back();
+            if (!packed.back().empty()) {
+                packed.back().push_back('\n');
+            }
+            packed.back().append(rec);
+        }
+    }
+    const auto& datagrams = options_.udp_batch ? packed : batch;
+
+    std::vector<iovec> iov(datagrams.size());
+    std::vector<mmsghdr> msgs(datagrams.size());
+    for (std::size_t i = 0; i < datagrams.size(); ++i) {
+        iov[i] = {const_cast<char*>(datagrams[i].data()), datagrams[i].size()};
+        msgs[i] = mmsghdr{};
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    std::size_t first = 0;
+    while (first < msgs.size()) {
+        const int sent = ::sendmmsg(fd_, msgs.data() + first, static_cast<unsigned>(msgs.size() - first), 0);
+        if (sent < 0) {
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_writable(fd_, options_.send_timeout)) {
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (!options_.udp_batch) {
+                return first;
+            }
+            return first == 0 ? 0 : records_through[first - 1];
+        }
+        first += static_cast<std::size_t>(sent);
+    }
+    return batch.size();
+}
+
+void NetworkSink::spool(std::span<const std::string> records) {
+    if (records.empty()) {
+        return;
+    }
+    if (options_.spool_path.empty()) {
+        std::lock_guard lock(m_);
+        dropped_ += records.size();
+        return;
+    }
+    std::ofstream out(options_.spool_path, std::ios::binary | std::ios::app);
+    std::uint64_t dropped = 0;
+    for (const auto& rec : records) {
+        const auto len = static_cast<std::uint32_t>(rec.size());
+        if (!out || spool_bytes_ + sizeof(len) + len > options_.spool_max_bytes) {
+            ++dropped;
+            continue;
+        }
+        out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        out.write(rec.data(), len);
+        spool_bytes_ += sizeof(len) + len;
+    }
+    if (dropped > 0) {
+        std::lock_guard lock(m_);
+        dropped_ += dropped;
+    }
+}
+
+bool NetworkSink::replay_spool() {
+    if (spool_bytes_ == 0 || options_.spool_path.empty()) {
+        return true;
+    }
+    std::ifstream in(options_.spool_path, std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(spool_read_offset_));
+    std::vector<std::string> batch;
+    while (true) {
+        std::uint32_t len = 0;
+        const bool more = static_cast<bool>(in.read(reinterpret_cast<char*>(&len), sizeof(len)));
+        if (more) {
+            std::string rec(len, '\0');
+            if (in.read(rec.data(), len)) {
+                batch.push_back(std::move(rec));
+            }
+        }
+        if (batch.size() == options_.max_batch || (!more && !batch.empty())) {
+            // Skip what the peer got on the next replay, even if the batch fails partway
+            const auto sent = send_batch(batch);
+            for (std::size_t i = 0; i < sent; ++i) {
+                spool_read_offset_ += sizeof(len) + batch[i].size();
+            }
+            if (sent < batch.size()) {
+                return false;
+            }
+            batch.clear();
+        }
+        if (!more) {
+            break;
+        }
+    }
+    std::ofstream(options_.spool_path, std::ios::binary | std::ios::trunc);
+    spool_read_offset_ = 0;
+    spool_bytes_ = 0;
+    return true;
+}
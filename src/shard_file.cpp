@@ -0,0 +1,76 @@
+#include "dawg-log/shard_file.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace DawgLog;
+
+namespace {
+template<typename T>
+T load(const char *p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+}
+
+ShardFileReader::ShardFileReader(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Failed to open log shard: " << path << std::endl;
+        return;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kShardFileHeaderBytes)) {
+        std::cerr << "Empty or unreadable log shard: " << path << std::endl;
+        ::close(fd);
+        return;
+    }
+    void* mapped = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Failed to map log shard: " << path << std::endl;
+        return;
+    }
+    const auto* data = static_cast<const char*>(mapped);
+    const auto size = static_cast<std::size_t>(st.st_size);
+    if (std::memcmp(data, kShardFileMagic, sizeof(kShardFileMagic)) != 0) {
+        std::cerr << "Not a dawg-log shard: " << path << std::endl;
+        ::munmap(mapped, size);
+        return;
+    }
+    // Records are read front to back exactly once
+    ::madvise(mapped, size, MADV_SEQUENTIAL);
+    data_ = data;
+    size_ = size;
+    shard_ = load<std::uint32_t>(data_ + 8);
+    pid_ = load<std::uint32_t>(data_ + 12);
+    pos_ = kShardFileHeaderBytes;
+}
+
+ShardFileReader::~ShardFileReader() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+bool ShardFileReader::next(ShardRecord& out) {
+    if (data_ == nullptr || size_ - pos_ < kShardRecordPrefix) {
+        return false;
+    }
+    const char* p = data_ + pos_;
+    const auto text_len = load<std::uint32_t>(p);
+    if (size_ - pos_ - kShardRecordPrefix < text_len) {
+        return false;
+    }
+    out.level = static_cast<LogLevel>(load<std::uint8_t>(p + 4));
+    out.seq = load<std::uint64_t>(p + 5);
+    out.mono_ns = load<std::uint64_t>(p + 13);
+    out.time_ns = load<std::int64_t>(p + 21);
+    out.text = std::string_view(p + kShardRecordPrefix, text_len);
+    pos_ += kShardRecordPrefix + text_len;
+    return true;
+}
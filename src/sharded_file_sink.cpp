@@ -0,0 +1,174 @@
+#include "dawg-log/sinks/sharded_file_sink.hpp"
+#include "dawg-log/shard_file.hpp"
+#include "dawg-log/memory_resource.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+#include <utility>
+
+using namespace DawgLog;
+
+struct ShardedFileSink::Shard {
+    /** Taken by the owning thread and by flush(); never contended while logging */
+    std::mutex m;
+    std::string path;
+    int fd{-1};
+    std::pmr::string buffer{log_memory_resource()};
+    std::uint64_t seq{0};
+
+    void append(const Record& r, std::string_view text) {
+        char prefix[kShardRecordPrefix];
+        const auto text_len = static_cast<std::uint32_t>(text.size());
+        const auto level = static_cast<std::uint8_t>(r.level);
+        const auto time_ns = static_cast<std::int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(r.time.time_since_epoch()).count());
+        std::memcpy(prefix, &text_len, 4);
+        std::memcpy(prefix + 4, &level, 1);
+        std::memcpy(prefix + 5, &seq, 8);
+        std::memcpy(prefix + 13, &r.mono_ns, 8);
+        std::memcpy(prefix + 21, &time_ns, 8);
+        buffer.append(prefix, sizeof(prefix));
+        buffer.append(text);
+        ++seq;
+    }
+
+    void flush_locked() {
+        std::size_t done = 0;
+        while (fd >= 0 && done < buffer.size()) {
+            const auto n = ::write(fd, buffer.data() + done, buffer.size() - done);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "Failed to write log shard " << path << ": " << std::strerror(errno) << std::endl;
+                break;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        buffer.clear();
+    }
+};
+
+namespace {
+std::atomic<std::uint64_t> next_sink_id{1};
+
+// Shards of the calling thread, one per sink it wrote to; flushed and closed when the thread exits
+struct LocalShards {
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<ShardedFileSink::Shard>>> entries;
+
+    ~LocalShards() {
+        for (auto& [id, shard] : entries) {
+            std::lock_guard lock(shard->m);
+            shard->flush_locked();
+            if (shard->fd >= 0) {
+                ::close(shard->fd);
+                shard->fd = -1;
+            }
+            shard->buffer.shrink_to_fit();
+        }
+    }
+};
+
+thread_local LocalShards local_shards;
+}
+
+ShardedFileSink::ShardedFileSink(std::string path, std::size_t buffer_bytes, LogLevel flush_level)
+    : path_(std::move(path)), buffer_bytes_(buffer_bytes), flush_level_(flush_level),
+      id_(next_sink_id.fetch_add(1, std::memory_order_relaxed)) {
+}
+
+ShardedFileSink::~ShardedFileSink() {
+    std::lock_guard lock(shards_m_);
+    for (auto& shard : shards_) {
+        std::lock_guard shard_lock(shard->m);
+        shard->flush_locked();
+        if (shard->fd >= 0) {
+            ::close(shard->fd);
+            shard->fd = -1;
+        }
+    }
+}
+
+ShardedFileSink::Shard& ShardedFileSink::local_shard() {
+    auto& entries = local_shards.entries;
+    for (const auto& [id, shard] : entries) {
+        if (id == id_) {
+            return *shard;
+        }
+    }
+    // Forget the shards of sinks that were destroyed meanwhile
+    std::erase_if(entries, [](const auto& entry) {
+        std::lock_guard lock(entry.second->m);
+        return entry.second->fd < 0;
+    });
+
+    auto shard = std::make_shared<Shard>();
+    shard->buffer.reserve(buffer_bytes_ + 1024);
+    {
+        std::lock_guard lock(shards_m_);
+        const auto number = static_cast<std::uint32_t>(shards_.size());
+        const auto pid = static_cast<std::uint32_t>(::getpid());
+        shard->path = path_ + "." + std::to_string(pid) + "." + std::to_string(number) + ".shard";
+        shard->fd = ::open(shard->path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (shard->fd < 0) {
+            std::cerr << "Failed to open log shard: " << shard->path << std::endl;
+        } else {
+            shard->buffer.append(kShardFileMagic, sizeof(kShardFileMagic));
+            shard->buffer.append(reinterpret_cast<const char*>(&number), 4);
+            shard->buffer.append(reinterpret_cast<const char*>(&pid), 4);
+        }
+        shards_.push_back(shard);
+    }
+    entries.emplace_back(id_, shard);
+    return *shard;
+}
+
+void ShardedFileSink::write(const Record& r, std::string_view formatted) {
+    auto& shard = local_shard();
+    std::lock_guard lock(shard.m);
+    if (shard.fd < 0) {
+        return;
+    }
+    shard.append(r, formatted);
+    if (shard.buffer.size() >= buffer_bytes_ || r.level >= flush_level_) {
+        shard.flush_locked();
+    }
+}
+
+void ShardedFileSink::write_batch(std::span<const SinkEntry> entries) {
+    auto& shard = local_shard();
+    std::lock_guard lock(shard.m);
+    if (shard.fd < 0) {
+        return;
+    }
+    bool urgent = false;
+    for (const auto& entry : entries) {
+        shard.append(*entry.rec, entry.formatted);
+        urgent = urgent || entry.rec->level >= flush_level_;
+    }
+    if (shard.buffer.size() >= buffer_bytes_ || urgent) {
+        shard.flush_locked();
+    }
+}
+
+void ShardedFileSink::flush() {
+    std::lock_guard lock(shards_m_);
+    for (auto& shard : shards_) {
+        std::lock_guard shard_lock(shard->m);
+        shard->flush_locked();
+    }
+}
+
+std::vector<std::string> ShardedFileSink::shard_paths() const {
+    std::lock_guard lock(shards_m_);
+    std::vector<std::string> paths;
+    paths.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        paths.push_back(shard->path);
+    }
+    return paths;
+}
@@ -0,0 +1,151 @@
+#include "dawg-log/shm_ring.hpp"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <unordered_set>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace DawgLog;
+
+namespace {
+ShmSlotHeader& slot_at(ShmRingHeader* header, std::uint64_t pos) {
+    auto* slots = reinterpret_cast<char*>(header + 1);
+    return *reinterpret_cast<ShmSlotHeader*>(slots + (pos % header->slot_count) * header->slot_bytes);
+}
+
+// Source file names of forwarded records; SourceLocation keeps a bare pointer, like tags they are never freed
+const char* intern_file(std::string_view file) {
+    static std::mutex m;
+    static std::unordered_set<std::string> files;
+    std::lock_guard lock(m);
+    return files.emplace(file).first->c_str();
+}
+}
+
+Record DawgLog::to_record(const ShmRecord& in, std::string_view app_name) {
+    const auto time = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(in.time_ns)));
+    Record rec{in.level, TagRegistry::intern(in.tag), SourceLocation{intern_file(in.file), in.line, ""},
+               app_name, in.message, time};
+    rec.thread_id = in.thread_id;
+    rec.thread_name = in.thread_name;
+    rec.cpu = in.cpu;
+    rec.mono_ns = in.mono_ns;
+    rec.payload = in.payload;
+    if (in.truncated) {
+        rec.message += " [truncated]";
+    }
+    return rec;
+}
+
+ShmRingReader::ShmRingReader(const std::string& name) : name_(name) {
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(ShmRingHeader))) {
+        ::close(fd);
+        return;
+    }
+    void* mapped = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Failed to map shared-memory ring: " << name << std::endl;
+        return;
+    }
+    auto* header = static_cast<ShmRingHeader*>(mapped);
+    size_ = static_cast<std::size_t>(st.st_size);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (std::memcmp(header->magic, kShmRingMagic, sizeof(kShmRingMagic)) != 0 || header->slot_count == 0 ||
+        header->slot_bytes < sizeof(ShmSlotHeader) ||
+        shm_ring_bytes(header->slot_count, header->slot_bytes) > size_) {
+        ::munmap(mapped, size_);
+        return;
+    }
+    header_ = header;
+    inode_ = static_cast<std::uint64_t>(st.st_ino);
+    buffer_.resize(header->slot_bytes);
+}
+
+ShmRingReader::~ShmRingReader() {
+    if (header_ != nullptr) {
+        ::munmap(header_, size_);
+    }
+}
+
+bool ShmRingReader::next(ShmRecord& out) {
+    while (true) {
+        const auto pos = header_->dequeue_pos.load(std::memory_order_relaxed);
+        auto& slot = slot_at(header_, pos);
+        const auto seq = slot.seq.load(std::memory_order_acquire);
+        if (seq != pos + 1) {
+            // Claimed but never published: only skip it once the producer is gone
+            if (header_->enqueue_pos.load(std::memory_order_acquire) > pos && !producer_alive()) {
+                slot.seq.store(pos + header_->slot_count, std::memory_order_release);
+                header_->dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+                ++torn_;
+                continue;
+            }
+            return false;
+        }
+        std::memcpy(buffer_.data(), reinterpret_cast<const char*>(&slot), header_->slot_bytes);
+        slot.seq.store(pos + header_->slot_count, std::memory_order_release);
+        header_->dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+
+        const auto& h = *reinterpret_cast<const ShmSlotHeader*>(buffer_.data());
+        const std::size_t payload = header_->slot_bytes - sizeof(ShmSlotHeader);
+        if (static_cast<std::size_t>(h.tag_len) + h.file_len + h.thread_name_len + h.message_len +
+                    h.payload_len > payload ||
+            h.level > static_cast<std::uint8_t>(LogLevel::critical)) {
+            ++torn_;
+            continue;
+        }
+        const char* data = buffer_.data() + sizeof(ShmSlotHeader);
+        out.level = static_cast<LogLevel>(h.level);
+        out.time_ns = h.time_ns;
+        out.mono_ns = h.mono_ns;
+        out.thread_id = h.thread_id;
+        out.cpu = h.cpu;
+        out.line = h.line;
+        out.truncated = h.truncated != 0;
+        out.tag = {data, h.tag_len};
+        data += h.tag_len;
+        out.file = {data, h.file_len};
+        data += h.file_len;
+        out.thread_name = {data, h.thread_name_len};
+        data += h.thread_name_len;
+        out.message = {data, h.message_len};
+        data += h.message_len;
+        out.payload = {data, h.payload_len};
+        return true;
+    }
+}
+
+std::uint64_t ShmRingReader::overruns() const {
+    return header_->overruns.load(std::memory_order_relaxed);
+}
+
+bool ShmRingReader::producer_alive() const {
+    return ::kill(header_->producer_pid, 0) == 0 || errno == EPERM;
+}
+
+bool ShmRingReader::replaced() const {
+    const int fd = ::shm_open(name_.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st{};
+    const bool other = ::fstat(fd, &st) == 0 && static_cast<std::uint64_t>(st.st_ino) != inode_;
+    ::close(fd);
+    return other;
+}
+
+std::string_view ShmRingReader::app_name() const {
+    return {header_->app_name, ::strnlen(header_->app_name, sizeof(header_->app_name))};
+}
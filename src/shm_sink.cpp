@@ -0,0 +1,119 @@
+#include "dawg-log/sinks/shm_sink.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace DawgLog;
+
+namespace {
+// Copy as much of `text` as fits, at most `limit` bytes
+std::size_t put(char*& out, std::size_t& room, std::string_view text, std::size_t limit) {
+    const auto n = std::min({text.size(), room, limit});
+    std::memcpy(out, text.data(), n);
+    out += n;
+    room -= n;
+    return n;
+}
+}
+
+ShmSink::ShmSink(const std::string& name, const std::string& app_name, std::size_t slot_count,
+                 std::size_t slot_bytes) {
+    slot_count = std::bit_ceil(std::max<std::size_t>(slot_count, 2));
+    slot_bytes = std::max(slot_bytes, sizeof(ShmSlotHeader) + 64);
+    slot_bytes = (slot_bytes + alignof(ShmSlotHeader) - 1) / alignof(ShmSlotHeader) * alignof(ShmSlotHeader);
+    const auto size = shm_ring_bytes(slot_count, slot_bytes);
+
+    // Start from a new segment: an agent still draining the old one keeps its mapping
+    ::shm_unlink(name.c_str());
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "Failed to create shared-memory ring: " << name << std::endl;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return;
+    }
+    void* mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Failed to map shared-memory ring: " << name << std::endl;
+        return;
+    }
+
+    auto* header = new (mapped) ShmRingHeader{};
+    header->slot_count = static_cast<std::uint32_t>(slot_count);
+    header->slot_bytes = static_cast<std::uint32_t>(slot_bytes);
+    header->producer_pid = static_cast<std::int32_t>(::getpid());
+    std::strncpy(header->app_name, app_name.c_str(), sizeof(header->app_name) - 1);
+    auto* slots = static_cast<char*>(mapped) + sizeof(ShmRingHeader);
+    for (std::size_t i = 0; i < slot_count; ++i) {
+        new (slots + i * slot_bytes) ShmSlotHeader{};
+        reinterpret_cast<ShmSlotHeader*>(slots + i * slot_bytes)->seq.store(i, std::memory_order_relaxed);
+    }
+    // The magic is written last: a reader that sees it sees an initialized ring
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, kShmRingMagic, sizeof(kShmRingMagic));
+    header_ = header;
+    size_ = size;
+}
+
+ShmSink::~ShmSink() {
+    if (header_ != nullptr) {
+        ::munmap(header_, size_);
+    }
+}
+
+void ShmSink::write(const Record& r, std::string_view) {
+    if (header_ == nullptr) {
+        return;
+    }
+    const auto slot_count = header_->slot_count;
+    auto* slots = reinterpret_cast<char*>(header_ + 1);
+    ShmSlotHeader* slot = nullptr;
+    auto pos = header_->enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        slot = reinterpret_cast<ShmSlotHeader*>(slots + (pos & (slot_count - 1)) * header_->slot_bytes);
+        const auto seq = slot->seq.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(seq - pos);
+        if (diff == 0) {
+            if (header_->enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            header_->overruns.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = header_->enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(r.time.time_since_epoch()).count();
+    slot->mono_ns = r.mono_ns;
+    slot->thread_id = r.thread_id;
+    slot->cpu = r.cpu;
+    slot->line = r.src.line;
+    slot->level = static_cast<std::uint8_t>(r.level);
+
+    constexpr std::size_t kMaxField = std::numeric_limits<std::uint16_t>::max();
+    char* out = reinterpret_cast<char*>(slot + 1);
+    std::size_t room = header_->slot_bytes - sizeof(ShmSlotHeader);
+    slot->tag_len = static_cast<std::uint16_t>(put(out, room, r.tag, kMaxField));
+    slot->file_len = static_cast<std::uint16_t>(put(out, room, r.src.file, kMaxField));
+    slot->thread_name_len = static_cast<std::uint16_t>(put(out, room, r.thread_name, kMaxField));
+    slot->message_len = static_cast<std::uint32_t>(put(out, room, r.message, r.message.size()));
+    slot->payload_len = static_cast<std::uint32_t>(put(out, room, r.payload, r.payload.size()));
+    slot->truncated = slot->message_len < r.message.size() || slot->payload_len < r.payload.size() ? 1 : 0;
+
+    slot->seq.store(pos + 1, std::memory_order_release);
+}
+
+std::uint64_t ShmSink::overruns() const {
+    return header_ != nullptr ? header_->overruns.load(std::memory_order_relaxed) : 0;
+}
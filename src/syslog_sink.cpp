@@ -1,4 +1,5 @@
 #include "dawg-log/sinks/syslog_sink.hpp"
+#include <algorithm>
 
 #ifdef LOGGERLIB_HAS_SYSLOG
 #include <syslog.h>
@@ -6,8 +7,15 @@
 
 using namespace DawgLog;
 
-SyslogSink::SyslogSink(std::string app_name)
-    : app_(std::move(app_name)) {
+namespace {
+// Room for "[part/parts] " and the syslog header in front of each payload piece
+constexpr std::size_t kPartOverhead = 64;
+// Pieces never get smaller than this, however long the header is
+constexpr std::size_t kMinPiece = 1024;
+}
+
+SyslogSink::SyslogSink(std::string app_name, std::size_t max_message_bytes)
+    : app_(std::move(app_name)), max_message_bytes_(max_message_bytes) {
     openlog(app_.c_str(), LOG_PID | LOG_NDELAY, LOG_USER);
 }
 
@@ -16,5 +24,21 @@ SyslogSink::~SyslogSink() {
 }
 
 void SyslogSink::write(const Record& r, std::string_view formatted) {
-    syslog(to_syslog_level(r.level), "%s", std::string(formatted).c_str());
+    const int priority = to_syslog_level(r.level);
+    const auto& payload = r.payload;
+    if (payload.empty() || formatted.size() + payload.size() + kPartOverhead <= max_message_bytes_) {
+        syslog(priority, "%.*s%.*s", static_cast<int>(formatted.size()), formatted.data(),
+               static_cast<int>(payload.size()), payload.data());
+        return;
+    }
+    const auto room = max_message_bytes_ > formatted.size() + kPartOverhead
+                          ? max_message_bytes_ - formatted.size() - kPartOverhead
+                          : 0;
+    const auto piece = std::max(room, kMinPiece);
+    const auto parts = (payload.size() + piece - 1) / piece;
+    for (std::size_t part = 0; part < parts; ++part) {
+        const auto chunk = payload.substr(part * piece, piece);
+        syslog(priority, "%.*s[%zu/%zu] %.*s", static_cast<int>(formatted.size()), formatted.data(), part + 1,
+               parts, static_cast<int>(chunk.size()), chunk.data());
+    }
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "dawg-log/tag_registry.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace DawgLog;
+
+namespace {
+constexpr std::size_t kChunkSize = 1024;
+constexpr std::size_t kChunkCount = TagRegistry::kMaxTags / kChunkSize;
+constexpr int kNoLevel = -1;
+
+struct Entry {
+    std::string name;
+    std::atomic<int> level{kNoLevel};
+};
+
+// Entries live in fixed chunks that are never moved, so readers can resolve an ID
+// without taking the lock while new tags are appended. The table is never freed:
+// records may still refer to tag names while static destructors run.
+struct Table {
+    std::mutex m;
+    std::unordered_map<std::string_view, TagId> ids;
+    std::array<std::atomic<Entry*>, kChunkCount> chunks{};
+    std::atomic<std::size_t> size{0};
+
+    Entry& entry(TagId id) {
+        return chunks[id / kChunkSize].load(std::memory_order_acquire)[id % kChunkSize];
+    }
+};
+
+Table& table() {
+    static Table* instance = new Table;
+    return *instance;
+}
+}
+
+Tag TagRegistry::intern(std::string_view name) {
+    auto& t = table();
+    std::lock_guard lock(t.m);
+    if (const auto it = t.ids.find(name); it != t.ids.end()) {
+        return Tag{it->second, it->first};
+    }
+    const auto id = static_cast<TagId>(t.size.load(std::memory_order_relaxed));
+    if (id >= kMaxTags) {
+        throw std::length_error("DawgLog: too many distinct tags");
+    }
+    auto& chunk = t.chunks[id / kChunkSize];
+    if (chunk.load(std::memory_order_relaxed) == nullptr) {
+        chunk.store(new Entry[kChunkSize], std::memory_order_release);
+    }
+    auto& e = t.entry(id);
+    e.name.assign(name);
+    t.ids.emplace(e.name, id);
+    t.size.store(id + 1, std::memory_order_release);
+    return Tag{id, e.name};
+}
+
+const std::string& TagRegistry::name(TagId id) {
+    return table().entry(id).name;
+}
+
+std::optional<LogLevel> TagRegistry::level(TagId id) {
+    const int lvl = table().entry(id).level.load(std::memory_order_relaxed);
+    if (lvl == kNoLevel) {
+        return std::nullopt;
+    }
+    return static_cast<LogLevel>(lvl);
+}
+
+void TagRegistry::set_level(TagId id, std::optional<LogLevel> lvl) {
+    table().entry(id).level.store(lvl ? static_cast<int>(*lvl) : kNoLevel, std::memory_order_relaxed);
+}
+
+void TagRegistry::clear_levels() {
+    auto& t = table();
+    std::lock_guard lock(t.m);
+    const auto count = t.size.load(std::memory_order_relaxed);
+    for (std::size_t id = 0; id < count; ++id) {
+        t.entry(static_cast<TagId>(id)).level.store(kNoLevel, std::memory_order_relaxed);
+    }
+}
+
+std::size_t TagRegistry::size() {
+    return table().size.load(std::memory_order_acquire);
+}
@@ -0,0 +1,44 @@
+#include "dawg-log/target_filter.hpp"
+#include <algorithm>
+#include <fnmatch.h>
+
+using namespace DawgLog;
+
+namespace {
+bool matches_any(const std::vector<std::string>& patterns, const char* file) {
+    return std::any_of(patterns.begin(), patterns.end(), [file](const std::string& pattern) {
+        return ::fnmatch(pattern.c_str(), file, 0) == 0;
+    });
+}
+}
+
+TargetFilter::TargetFilter(const Options& options)
+    : min_level_(options.min_level),
+      include_tags_(make_bitset(options.include_tags)),
+      exclude_tags_(make_bitset(options.exclude_tags)),
+      include_sources_(options.include_sources),
+      exclude_sources_(options.exclude_sources),
+      has_sources_(!options.include_sources.empty() || !options.exclude_sources.empty()) {
+}
+
+TargetFilter::Bitset TargetFilter::make_bitset(const std::vector<std::string>& tags) {
+    Bitset bits;
+    for (const auto& tag : tags) {
+        const auto id = TagRegistry::intern(tag).id;
+        if (bits.size() <= id / 64) {
+            bits.resize(id / 64 + 1, 0);
+        }
+        bits[id / 64] |= std::uint64_t{1} << (id % 64);
+    }
+    return bits;
+}
+
+bool TargetFilter::accepts_source(const char* file) const {
+    if (file == nullptr) {
+        file = "";
+    }
+    if (!include_sources_.empty() && !matches_any(include_sources_, file)) {
+        return false;
+    }
+    return !matches_any(exclude_sources_, file);
+}
@@ -0,0 +1,342 @@
+#include "dawg-log/target_queue.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace DawgLog;
+
+namespace {
+constexpr auto kIdleWait = std::chrono::milliseconds(100);
+
+// Smaller batches are formatted by the writer alone; waking the workers would cost more
+constexpr std::size_t kMinRecordsPerWorker = 64;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+}
+
+// Formats a batch with one formatter copy per thread; the calling writer thread takes the first part
+class TargetQueue::FormatPool {
+public:
+    FormatPool(const Sink& sink, std::vector<FormatterPtr> formatters, BackendOptions backend)
+        : sink_(sink), formatters_(std::move(formatters)), backend_(std::move(backend)) {
+        for (std::size_t i = 1; i < formatters_.size(); ++i) {
+            threads_.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    ~FormatPool() {
+        {
+            std::lock_guard lock(m_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void format(std::span<Item> items) {
+        const auto parts = std::clamp<std::size_t>(items.size() / kMinRecordsPerWorker, 1, formatters_.size());
+        if (parts == 1) {
+            format_range(*formatters_[0], items);
+            return;
+        }
+        {
+            std::lock_guard lock(m_);
+            items_ = items;
+            parts_ = parts;
+            remaining_ = parts - 1;
+            ++generation_;
+        }
+        start_cv_.notify_all();
+        format_range(*formatters_[0], part(0));
+        std::unique_lock lock(m_);
+        while (remaining_ > 0) {
+            done_cv_.wait_for(lock, kIdleWait);
+        }
+    }
+
+private:
+    void format_range(Formatter& formatter, std::span<Item> items) const {
+        for (auto& item : items) {
+            try {
+                bool sink_writes_payload = false;
+                item.formatted = format_for_sink(formatter, sink_, item.rec, sink_writes_payload);
+                if (!sink_writes_payload) {
+                    item.rec.payload = {};
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "DawgLog: target queue formatter failed: " << e.what() << std::endl;
+            }
+        }
+    }
+
+    [[nodiscard]] std::span<Item> part(std::size_t k) const {
+        const auto begin = items_.size() * k / parts_;
+        const auto end = items_.size() * (k + 1) / parts_;
+        return items_.subspan(begin, end - begin);
+    }
+
+    void run(std::size_t worker) {
+        // Same placement as the writer thread, away from the application's cores
+        apply_backend_options(backend_);
+        std::uint64_t seen = 0;
+        std::unique_lock lock(m_);
+        while (!stop_) {
+            if (generation_ == seen) {
+                start_cv_.wait_for(lock, kIdleWait);
+                continue;
+            }
+            seen = generation_;
+            if (worker >= parts_) {
+                continue;
+            }
+            const auto items = part(worker);
+            lock.unlock();
+            format_range(*formatters_[worker], items);
+            lock.lock();
+            if (--remaining_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+
+    const Sink& sink_;
+    std::vector<FormatterPtr> formatters_;
+    BackendOptions backend_;
+    std::vector<std::thread> threads_;
+    std::mutex m_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    std::span<Item> items_;
+    std::size_t parts_{1};
+    std::size_t remaining_{0};
+    std::uint64_t generation_{0};
+    bool stop_{false};
+};
+
+TargetQueue::TargetQueue(Sink& sink, Options options, const Formatter* formatter)
+    : sink_(sink), options_(options),
+      resource_(options.memory_resource != nullptr ? options.memory_resource : log_memory_resource()),
+      items_(resource_) {
+    if (options_.capacity == 0) {
+        options_.capacity = 1;
+    }
+    if (formatter != nullptr && options_.format_workers > 0) {
+        std::vector<FormatterPtr> formatters;
+        for (std::size_t i = 0; i < options_.format_workers; ++i) {
+            auto copy = formatter->clone();
+            if (!copy) {
+                formatters.clear();
+                break;
+            }
+            formatters.push_back(std::move(copy));
+        }
+        if (!formatters.empty()) {
+            pool_ = std::make_unique<FormatPool>(sink_, std::move(formatters), options_.backend);
+        }
+    }
+    worker_ = std::thread([this] { run(); });
+}
+
+TargetQueue::~TargetQueue() {
+    {
+        std::lock_guard lock(m_);
+        stop_ = true;
+    }
+    pending_.store(true, std::memory_order_release);
+    work_cv_.notify_one();
+    worker_.join();
+}
+
+bool TargetQueue::full(std::size_t incoming) const {
+    const auto count = items_.size() + writing_;
+    return count > 0 && (count >= options_.capacity || bytes_ + incoming > options_.max_bytes);
+}
+
+TargetQueue::Item TargetQueue::make_item(const Record& rec, std::string formatted) const {
+    return Item{Record(rec, resource_), std::move(formatted), std::pmr::string(rec.payload, resource_)};
+}
+
+void TargetQueue::enqueue_locked(Item item, std::unique_lock<std::mutex>& lock) {
+    const auto bytes = item.bytes();
+    if (options_.budget && !options_.budget->try_acquire(item.rec.level, bytes)) {
+        return;
+    }
+    switch (options_.overflow) {
+        case Overflow::DROP_NEWEST:
+            if (full(bytes)) {
+                ++dropped_;
+                release(bytes);
+                return;
+            }
+            break;
+        case Overflow::DROP_OLDEST:
+            while (full(bytes) && !items_.empty()) {
+                bytes_ -= items_.front().bytes();
+                release(items_.front().bytes());
+                items_.pop_front();
+                ++dropped_;
+            }
+            break;
+        case Overflow::BLOCK:
+            while (full(bytes) && !stop_) {
+                // Let the writer start on what is already queued
+                pending_.store(true, std::memory_order_release);
+                work_cv_.notify_one();
+                space_cv_.wait_for(lock, kIdleWait);
+            }
+            break;
+    }
+    bytes_ += bytes;
+    items_.push_back(std::move(item));
+}
+
+void TargetQueue::release(std::size_t bytes) {
+    if (options_.budget) {
+        options_.budget->release(bytes);
+    }
+}
+
+void TargetQueue::push(const Record& rec, std::string formatted) {
+    {
+        std::unique_lock lock(m_);
+        enqueue_locked(make_item(rec, std::move(formatted)), lock);
+    }
+    notify_pending();
+}
+
+void TargetQueue::push_batch(std::span<const SinkEntry> entries) {
+    {
+        std::unique_lock lock(m_);
+        for (const auto& entry : entries) {
+            enqueue_locked(make_item(*entry.rec, std::string(entry.formatted)), lock);
+        }
+    }
+    notify_pending();
+}
+
+void TargetQueue::notify_pending() {
+    pending_.store(true, std::memory_order_release);
+    if (options_.backend.wait == BackendOptions::Wait::CONDVAR) {
+        work_cv_.notify_one();
+    }
+}
+
+void TargetQueue::flush() {
+    std::unique_lock lock(m_);
+    while (!items_.empty() || writing_ > 0) {
+        work_cv_.notify_one();
+        space_cv_.wait_for(lock, kIdleWait);
+    }
+}
+
+std::uint64_t TargetQueue::dropped() const {
+    std::lock_guard lock(m_);
+    return dropped_;
+}
+
+void TargetQueue::wait_for_work(std::unique_lock<std::mutex>& lock) {
+    const auto& backend = options_.backend;
+    switch (backend.wait) {
+        case BackendOptions::Wait::CONDVAR:
+            work_cv_.wait_for(lock, kIdleWait);
+            return;
+        case BackendOptions::Wait::SLEEP:
+            lock.unlock();
+            std::this_thread::sleep_for(backend.sleep_interval);
+            lock.lock();
+            return;
+        case BackendOptions::Wait::SPIN:
+        case BackendOptions::Wait::SPIN_YIELD:
+            lock.unlock();
+            for (unsigned n = 0; !pending_.load(std::memory_order_acquire); ++n) {
+                if (backend.wait == BackendOptions::Wait::SPIN_YIELD && n >= backend.spin_iterations) {
+                    std::this_thread::yield();
+                } else {
+                    cpu_relax();
+                }
+            }
+            lock.lock();
+            return;
+    }
+}
+
+void TargetQueue::run() {
+    apply_backend_options(options_.backend);
+    std::vector<Item> batch;
+    std::vector<SinkEntry> entries;
+    std::unique_lock lock(m_);
+    while (true) {
+        if (items_.empty()) {
+            if (stop_) {
+                return;
+            }
+            pending_.store(false, std::memory_order_relaxed);
+            wait_for_work(lock);
+            continue;
+        }
+        batch.clear();
+        std::size_t batch_bytes = 0;
+        while (!items_.empty()) {
+            batch_bytes += items_.front().bytes();
+            batch.push_back(std::move(items_.front()));
+            items_.pop_front();
+        }
+        writing_ = batch.size();
+        lock.unlock();
+
+        for (auto& item : batch) {
+            item.bind_payload();
+        }
+        try {
+            if (pool_ && sink_.needs_formatting()) {
+                pool_->format(batch);
+            }
+            entries.clear();
+            for (const auto& item : batch) {
+                entries.push_back(SinkEntry{&item.rec, item.formatted});
+            }
+            sink_.write_batch(entries);
+        } catch (const std::exception& e) {
+            std::cerr << "DawgLog: target queue sink failed: " << e.what() << std::endl;
+        }
+
+        lock.lock();
+        bytes_ -= batch_bytes;
+        release(batch_bytes);
+        writing_ = 0;
+        space_cv_.notify_all();
+    }
+}
+
+TargetQueue::Overflow DawgLog::string_to_overflow(const std::string& name) {
+    if (name == "drop_oldest") {
+        return TargetQueue::Overflow::DROP_OLDEST;
+    }
+    if (name == "block") {
+        return TargetQueue::Overflow::BLOCK;
+    }
+    return TargetQueue::Overflow::DROP_NEWEST;
+}
+
+std::string DawgLog::format_for_sink(Formatter& formatter, const Sink& sink, const Record& rec,
+                                     bool& sink_writes_payload) {
+    auto formatted = formatter.format(rec);
+    sink_writes_payload = false;
+    if (rec.payload.empty() || formatter.embeds_payload()) {
+        return formatted;
+    }
+    if (sink.writes_payload()) {
+        sink_writes_payload = true;
+        return formatted;
+    }
+    formatted.append(rec.payload);
+    return formatted;
+}
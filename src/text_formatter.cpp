@@ -6,7 +6,24 @@ using namespace DawgLog;
 std::string TextFormatter::format(const Record& r) {
     std::ostringstream oss;
     oss << r.app_name << ' ' << r.timestamp << " [" << r.tag << "] "
-        << to_string(r.level) << ": " << r.message
-        << ", SOURCE: " << r.src.file << ':' << r.src.line;
+        << to_string(r.level) << ": " << r.message;
+    if (r.span_ns != 0) {
+        oss << " (" << r.span_ns << " ns)";
+    }
+    if (r.context) {
+        oss << " {" << r.context->text() << '}';
+    }
+    oss << ", SOURCE: " << r.src.file << ':' << r.src.line;
+    if (thread_fields_) {
+        oss << ", THREAD: " << r.thread_id;
+        if (!r.thread_name.empty()) {
+            oss << '(' << r.thread_name << ')';
+        }
+        oss << " CPU: " << r.cpu << " MONO: " << r.mono_ns;
+    }
+    if (!r.payload.empty()) {
+        // The payload itself follows the header (written by the sink)
+        oss << ", PAYLOAD(" << r.payload.size() << "): ";
+    }
     return oss.str();
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "dawg-log/thread_info.hpp"
+#include <chrono>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace DawgLog;
+
+namespace {
+constexpr std::size_t kMaxThreadName = 15;
+
+ThreadInfo load_thread_info() {
+    ThreadInfo info;
+    info.id = static_cast<std::uint32_t>(::syscall(SYS_gettid));
+    char name[kMaxThreadName + 1] = {};
+    if (::pthread_getname_np(::pthread_self(), name, sizeof(name)) == 0) {
+        info.name = name;
+    }
+    return info;
+}
+
+ThreadInfo& local_thread() {
+    thread_local ThreadInfo info = load_thread_info();
+    return info;
+}
+}
+
+const ThreadInfo& DawgLog::current_thread() {
+    return local_thread();
+}
+
+void DawgLog::set_thread_name(std::string_view name) {
+    auto& info = local_thread();
+    info.name.assign(name.substr(0, kMaxThreadName));
+    ::pthread_setname_np(::pthread_self(), info.name.c_str());
+}
+
+int DawgLog::current_cpu() {
+    return ::sched_getcpu();
+}
+
+std::uint64_t DawgLog::monotonic_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,40 @@
+#include "dawg-log/formatters/trace_event_formatter.hpp"
+#include <nlohmann/json.hpp>
+#include <unistd.h>
+
+using namespace DawgLog;
+
+TraceEventFormatter::TraceEventFormatter() : pid_(static_cast<int>(::getpid())) {
+}
+
+std::string TraceEventFormatter::format(const Record& r) {
+    nlohmann::json j;
+    j["name"] = r.span_ns != 0 ? std::string_view(r.message) : std::string_view(to_string(r.level));
+    j["cat"] = r.tag;
+    j["pid"] = pid_;
+    j["tid"] = r.thread_id;
+    if (r.span_ns != 0) {
+        j["ph"] = "X";
+        j["ts"] = static_cast<double>(r.mono_ns - r.span_ns) / 1000.0;
+        j["dur"] = static_cast<double>(r.span_ns) / 1000.0;
+    } else {
+        j["ph"] = "i";
+        j["s"] = "t";
+        j["ts"] = static_cast<double>(r.mono_ns) / 1000.0;
+    }
+
+    nlohmann::json args;
+    args["level"] = std::string(to_string(r.level));
+    if (r.span_ns == 0) {
+        args["message"] = r.message;
+    }
+    if (!r.payload.empty()) {
+        args["payload_bytes"] = r.payload.size();
+    }
+    args["source"] = std::string(r.src.file) + ":" + std::to_string(r.src.line);
+    if (r.context) {
+        args["context"] = nlohmann::json::parse(r.context->json());
+    }
+    j["args"] = std::move(args);
+    return j.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
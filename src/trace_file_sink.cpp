@@ -0,0 +1,47 @@
+#include "dawg-log/sinks/trace_file_sink.hpp"
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <unistd.h>
+
+using namespace DawgLog;
+
+TraceFileSink::TraceFileSink(std::string path)
+    : path_(std::move(path)), out_(path_, std::ios::trunc) {
+    if (!out_.is_open()) {
+        std::cerr << "Failed to open trace file: " << path_ << std::endl;
+        return;
+    }
+    out_ << "[\n";
+}
+
+TraceFileSink::~TraceFileSink() {
+    if (out_.is_open()) {
+        out_ << "\n]\n";
+    }
+}
+
+void TraceFileSink::write_event_locked(const std::string& event) {
+    if (!first_) {
+        out_ << ",\n";
+    }
+    first_ = false;
+    out_ << event;
+}
+
+void TraceFileSink::write(const Record& r, std::string_view) {
+    std::lock_guard lock(m_);
+    if (!out_.is_open()) {
+        return;
+    }
+    if (!r.thread_name.empty() && named_threads_.insert(r.thread_id).second) {
+        nlohmann::json meta;
+        meta["name"] = "thread_name";
+        meta["ph"] = "M";
+        meta["pid"] = static_cast<int>(::getpid());
+        meta["tid"] = r.thread_id;
+        meta["args"]["name"] = r.thread_name;
+        write_event_locked(meta.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+    }
+    write_event_locked(formatter_.format(r));
+    out_.flush();
+}
@@ -7,9 +7,12 @@
 using namespace DawgLog;
 
 std::string DawgLog::make_timestamp() {
+    return make_timestamp(std::chrono::system_clock::now());
+}
+
+std::string DawgLog::make_timestamp(std::chrono::system_clock::time_point time) {
     using namespace std::chrono;
-    auto now = system_clock::now();
-    std::time_t t = system_clock::to_time_t(now);
+    std::time_t t = system_clock::to_time_t(time);
     std::tm tm{};
 #if defined(_WIN32)
     localtime_s(&tm, &t);
@@ -21,11 +24,23 @@ std::string DawgLog::make_timestamp() {
     return std::string{buf.data()};
 }
 
+std::int64_t DawgLog::to_epoch_ms(std::chrono::system_clock::time_point time) {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(time.time_since_epoch()).count();
+}
+
 const std::map<std::string, SinkType>& DawgLog::get_sink_type() {
     static const std::map<std::string, SinkType> mapping = {
         {"console", SinkType::CONSOLE},
         {"syslog", SinkType::SYSLOG},
-        {"file", SinkType::FILE}
+        {"file", SinkType::FILE},
+        {"compressed_file", SinkType::COMPRESSED_FILE},
+        {"archive", SinkType::ARCHIVE},
+        {"network", SinkType::NETWORK},
+        {"shm", SinkType::SHM},
+        {"journald", SinkType::JOURNALD},
+        {"sharded_file", SinkType::SHARDED_FILE},
+        {"trace", SinkType::TRACE}
     };
     return mapping;
 }
@@ -33,7 +48,8 @@ const std::map<std::string, SinkType>& DawgLog::get_sink_type() {
 const std::map<std::string, FormatterType>& DawgLog::get_formatter_type() {
     static const std::map<std::string, FormatterType> mapping = {
         {"text", FormatterType::TEXT},
-        {"json", FormatterType::JSON}
+        {"json", FormatterType::JSON},
+        {"trace", FormatterType::TRACE}
     };
     return mapping;
 }
@@ -57,3 +73,12 @@ FormatterType DawgLog::string_to_formatter_type(const std::string& type) {
     }
     return it->second;
 }
+
+LogLevel DawgLog::string_to_level(const std::string& name, LogLevel fallback) {
+    LogLevel level = fallback;
+    if (!parse_level(name, level)) {
+        std::cerr << "Unknown log level '" << name << "'. Falling back to '" << to_string(fallback) << "'."
+                  << std::endl;
+    }
+    return level;
+}
@@ -1,14 +1,659 @@
 #include "dawg-log/logger.hpp"
 #include "dawg-log/config.hpp"
 #include "dawg-log/tagged_logger.hpp"
+#include "dawg-log/formatters/text_formatter.hpp"
+#include "dawg-log/formatters/json_formatter.hpp"
+#include "dawg-log/formatters/trace_event_formatter.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <thread>
+#include <string>
+#include <vector>
 
 using namespace DawgLog;
 
+namespace {
+struct MemorySink : Sink {
+    explicit MemorySink(std::vector<std::string>& lines) : lines(lines) {}
+
+    void write(const Record& r, std::string_view) override {
+        lines.push_back(to_string(r.level) + " " + std::string(r.message));
+    }
+
+    std::vector<std::string>& lines;
+};
+
+// Blocks every write until the gate opens, like a stalled remote sink
+struct GatedSink : Sink {
+    GatedSink(std::atomic<bool>& open, std::atomic<int>& written) : open(open), written(written) {}
+
+    void write(const Record&, std::string_view) override {
+        while (!open.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ++written;
+    }
+
+    std::atomic<bool>& open;
+    std::atomic<int>& written;
+};
+
+// Records how many write_batch() calls delivered how many records
+struct BatchCountingSink : Sink {
+    void write(const Record& r, std::string_view formatted) override {
+        lines.emplace_back(formatted);
+    }
+
+    void write_batch(std::span<const SinkEntry> entries) override {
+        batch_sizes.push_back(entries.size());
+        for (const auto& entry : entries) {
+            lines.emplace_back(entry.formatted);
+        }
+    }
+
+    std::vector<std::string> lines;
+    std::vector<std::size_t> batch_sizes;
+};
+
+void init_memory_logger(const Config& cfg, std::vector<std::string>& lines) {
+    std::vector<Logger::Target> targets;
+    targets.emplace_back(Logger::Target{std::make_unique<MemorySink>(lines), std::make_unique<TextFormatter>()});
+    Logger::init(cfg, std::move(targets));
+}
+
+void test_config_sink_options() {
+    const auto path = std::filesystem::temp_directory_path() / "dawglog_test_config.json";
+    {
+        std::ofstream out(path);
+        out << R"({"sink": "compressed_file", "frame_bytes": 4194304, "port": 6514,
+                  "targets": [{"sink": "archive", "block_bytes": 8192},
+                              {"sink": "network", "protocol": "udp", "udp_batch": true, "max_batch": 32}]})";
+    }
+    const Config cfg{path.string()};
+    std::filesystem::remove(path);
+    assert(cfg.sink == SinkType::COMPRESSED_FILE);
+    assert(cfg.sink_options.frame_bytes == 4194304);
+    assert(cfg.sink_options.port == 6514);
+    assert(cfg.targets.size() == 2);
+    assert(cfg.targets[0].block_bytes == 8192);
+    assert(cfg.targets[0].frame_bytes == Config::TargetConfig{}.frame_bytes);
+    assert(cfg.targets[1].udp_batch);
+    assert(cfg.targets[1].max_batch == 32);
+}
+
+void test_flight_recorder() {
+    std::vector<std::string> lines;
+    Config cfg{"config.json"};
+    cfg.level = LogLevel::info;
+    cfg.flight_recorder.enabled = true;
+    cfg.flight_recorder.capacity = 2;
+    init_memory_logger(cfg, lines);
+
+    TaggedLogger t("fr");
+    t.debug(LOG_SRC, "dropped {}", 1);
+    t.debug(LOG_SRC, "kept {} {}", 2, std::string("two"));
+    t.debug(LOG_SRC, "kept {:.1f}", 3.25);
+    t.info(LOG_SRC, "plain");
+    assert(lines.size() == 1);
+
+    t.error(LOG_SRC, "boom");
+    assert(lines.size() == 5);
+    assert(lines[2] == "DEBUG kept 2 two");
+    assert(lines[3] == "DEBUG kept 3.2");
+    assert(lines[4] == "ERROR boom");
+
+    t.error(LOG_SRC, "again");
+    assert(lines.size() == 6);
+}
+
+void test_lazy_macros() {
+    std::vector<std::string> lines;
+    Config cfg{"config.json"};
+    cfg.level = LogLevel::info;
+    init_memory_logger(cfg, lines);
+
+    int evaluated = 0;
+    const auto expensive = [&] {
+        ++evaluated;
+        return std::string("dump");
+    };
+    TaggedLogger t("lazy");
+    TAG_DEBUG(t, "state {}", expensive());
+    DEBUG("state {}", expensive());
+    assert(evaluated == 0);
+    assert(lines.empty());
+
+    TAG_INFO(t, "state {}", expensive());
+    assert(evaluated == 1);
+    assert(lines.back() == "INFO state dump");
+
+    t.debug(LOG_SRC, "state {}", lazy(expensive));
+    assert(evaluated == 1);
+    t.info(LOG_SRC, "state {}", lazy(expensive));
+    assert(evaluated == 2);
+
+    set_log_site_enabled(__FILE__, __LINE__ + 1, false);
+    TAG_INFO(t, "state {}", expensive());
+    assert(evaluated == 2);
+    assert(lines.size() == 2);
+}
+
+void test_bytes() {
+    assert(fmt::format("{:b}", bytes(std::string("Man"))) == "TWFu");
+    assert(fmt::format("{:b}", bytes(std::string("hello"))) == "aGVsbG8=");
+    assert(fmt::format("{:X}", bytes(std::string("\x01\xab"))) == "01AB");
+
+    // The SIMD paths against a plain byte-at-a-time encoding, across block boundaries
+    const char* digits = "0123456789abcdef";
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::vector<unsigned char> data;
+    for (std::size_t n = 0; n <= 300; n = n < 100 ? n + 1 : n + 97) {
+        data.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            data[i] = static_cast<unsigned char>(i * 37 + n);
+        }
+        std::string hex;
+        std::string base64;
+        for (std::size_t i = 0; i < n; ++i) {
+            hex += digits[data[i] >> 4];
+            hex += digits[data[i] & 0x0f];
+        }
+        for (std::size_t i = 0; i < n; i += 3) {
+            const unsigned v = data[i] << 16 | (i + 1 < n ? data[i + 1] << 8 : 0) | (i + 2 < n ? data[i + 2] : 0);
+            base64 += alphabet[v >> 18 & 0x3f];
+            base64 += alphabet[v >> 12 & 0x3f];
+            base64 += i + 1 < n ? alphabet[v >> 6 & 0x3f] : '=';
+            base64 += i + 2 < n ? alphabet[v & 0x3f] : '=';
+        }
+        assert(fmt::format("{}", bytes(data)) == hex);
+        assert(fmt::format("{:b}", bytes(data)) == base64);
+        assert(fmt::format("{:d}", bytes(data)).size() == encoded_size(BytesFormat::DUMP, n));
+    }
+
+    // Formatting encodes in chunks; the result must match one encode_bytes() call
+    data.resize(10000);
+    for (const auto format : {BytesFormat::HEX, BytesFormat::HEX_UPPER, BytesFormat::DUMP, BytesFormat::BASE64}) {
+        std::string whole(encoded_size(format, data.size()), '\0');
+        encode_bytes(format, std::as_bytes(std::span(data)), whole.data());
+        const char* spec = format == BytesFormat::HEX ? "{:x}" : format == BytesFormat::HEX_UPPER ? "{:X}"
+                           : format == BytesFormat::DUMP ? "{:d}" : "{:b}";
+        assert(fmt::format(fmt::runtime(spec), bytes(data)) == whole);
+    }
+
+    const char text[] = "Hello, world!\n\x00\x01 and more";
+    assert(fmt::format("{:d}", bytes(text, sizeof(text) - 1)) ==
+           "00000000  48 65 6c 6c 6f 2c 20 77  6f 72 6c 64 21 0a 00 01  |Hello, world!...|\n"
+           "00000010  20 61 6e 64 20 6d 6f 72  65                       | and more|");
+
+    std::vector<std::string> lines;
+    Config cfg{"config.json"};
+    init_memory_logger(cfg, lines);
+    TaggedLogger t("bytes");
+    const std::array<std::uint16_t, 4> words{0x0102, 0x0304, 0x0506, 0x0708};
+    TAG_INFO(t, "frame {:.4}", bytes(words));
+    assert(lines.back() == "INFO frame 02010403... (8 bytes)");
+    TAG_INFO(t, "frame {:.3b}", bytes(words.data(), 2));
+    assert(lines.back() == "INFO frame AgE=");
+}
+
+void test_tag_levels() {
+    std::vector<std::string> lines;
+    Config cfg{"config.json"};
+    cfg.level = LogLevel::info;
+    cfg.tag_levels["verbose"] = LogLevel::debug;
+    init_memory_logger(cfg, lines);
+
+    TaggedLogger verbose("verbose");
+    TaggedLogger quiet("quiet");
+    assert(verbose.tag_id() == TagRegistry::intern("verbose").id);
+    assert(verbose.tag() == "verbose");
+
+    TAG_DEBUG(verbose, "shown");
+    TAG_DEBUG(quiet, "hidden");
+    assert(lines.size() == 1);
+
+    Logger::instance().set_tag_level("verbose", std::nullopt);
+    TAG_DEBUG(verbose, "hidden");
+    Logger::instance().set_tag_level("quiet", LogLevel::debug);
+    TAG_DEBUG(quiet, "shown");
+    assert(lines.size() == 2);
+    assert(lines.back() == "DEBUG shown");
+}
+
+void test_target_queue() {
+    std::vector<std::string> lines;
+    std::atomic<bool> open{false};
+    std::atomic<int> written{0};
+    std::vector<Logger::Target> targets;
+    targets.emplace_back(Logger::Target{std::make_unique<MemorySink>(lines), std::make_unique<TextFormatter>()});
+    Logger::Target slow{std::make_unique<GatedSink>(open, written), std::make_unique<TextFormatter>()};
+    slow.queue = std::make_unique<TargetQueue>(*slow.sink, TargetQueue::Options{4, 1 << 20,
+                                                   TargetQueue::Overflow::DROP_NEWEST});
+    auto* queue = slow.queue.get();
+    targets.emplace_back(std::move(slow));
+    Logger::init(Config{"config.json"}, std::move(targets));
+
+    TaggedLogger t("queue");
+    for (int i = 0; i < 20; ++i) {
+        t.info(LOG_SRC, "record {}", i);
+    }
+    assert(lines.size() == 20);
+    assert(written == 0);
+    assert(queue->dropped() >= 16);
+
+    open = true;
+    Logger::instance().flush();
+    assert(written + static_cast<int>(queue->dropped()) == 20);
+}
+
+void test_format_workers() {
+    std::vector<Logger::Target> targets;
+    Logger::Target target{std::make_unique<BatchCountingSink>(), std::make_unique<TextFormatter>()};
+    auto* sink = static_cast<BatchCountingSink*>(target.sink.get());
+    TargetQueue::Options options;
+    options.capacity = 100000;
+    options.overflow = TargetQueue::Overflow::BLOCK;
+    options.format_workers = 4;
+    target.queue = std::make_unique<TargetQueue>(*target.sink, options, target.formatter.get());
+    assert(target.queue->formats_records());
+    targets.push_back(std::move(target));
+    Logger::init(Config{"config.json"}, std::move(targets));
+
+    TaggedLogger t("workers");
+    constexpr int kRecords = 5000;
+    for (int i = 0; i < kRecords; ++i) {
+        t.info(LOG_SRC, "record {}", i);
+    }
+    Logger::instance().flush();
+    assert(sink->lines.size() == kRecords);
+    for (int i = 0; i < kRecords; ++i) {
+        assert(sink->lines[i].find("[workers] INFO: record " + std::to_string(i) + ",") != std::string::npos);
+    }
+
+    // The workers run with the backend options of the writer thread
+    struct NiceFormatter : Formatter {
+        explicit NiceFormatter(std::vector<int>& nice) : nice(&nice) {}
+
+        std::string format(const Record& r) override {
+            const int value = ::getpriority(PRIO_PROCESS, static_cast<id_t>(::gettid()));
+            std::lock_guard lock(*m);
+            nice->push_back(value);
+            return std::string(r.message);
+        }
+
+        FormatterPtr clone() const override { return std::make_unique<NiceFormatter>(*this); }
+
+        std::vector<int>* nice;
+        std::shared_ptr<std::mutex> m = std::make_shared<std::mutex>();
+    };
+    struct HeldSink : BatchCountingSink {
+        void write_batch(std::span<const SinkEntry> entries) override {
+            while (!open.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            BatchCountingSink::write_batch(entries);
+        }
+
+        std::atomic<bool> open{false};
+    };
+    std::vector<int> nice;
+    NiceFormatter nice_formatter(nice);
+    HeldSink held;
+    options.backend.nice = 7;
+    {
+        TargetQueue queue(held, options, &nice_formatter);
+        // The first batch holds the writer, so the rest arrives as one batch big enough for all workers
+        for (int i = 0; i < kRecords; ++i) {
+            queue.push(Record{LogLevel::info, "workers", LOG_SRC, "test", "nice"}, {});
+        }
+        held.open = true;
+        queue.flush();
+    }
+    assert(nice.size() == kRecords);
+    assert(std::all_of(nice.begin(), nice.end(), [](int value) { return value == 7; }));
+
+    // Formatters that cannot be cloned keep formatting in the logging thread
+    struct Uncloneable : Formatter {
+        std::string format(const Record& r) override { return std::string(r.message); }
+    };
+    Uncloneable formatter;
+    BatchCountingSink plain;
+    TargetQueue queue(plain, options, &formatter);
+    assert(!queue.formats_records());
+}
+
+// Counts what is allocated through it, like an application arena would
+struct CountingResource : std::pmr::memory_resource {
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        live += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        live -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::size_t allocations{0};
+    std::size_t live{0};
+};
+
+void test_memory_resource() {
+    CountingResource global;
+    set_log_memory_resource(&global);
+    {
+        std::vector<std::string> lines;
+        std::atomic<bool> open{false};
+        std::atomic<int> written{0};
+        CountingResource queue_resource;
+        std::vector<Logger::Target> targets;
+        targets.emplace_back(Logger::Target{std::make_unique<MemorySink>(lines), std::make_unique<TextFormatter>()});
+        Logger::Target queued{std::make_unique<GatedSink>(open, written), std::make_unique<TextFormatter>()};
+        TargetQueue::Options options;
+        options.memory_resource = &queue_resource;
+        queued.queue = std::make_unique<TargetQueue>(*queued.sink, options);
+        targets.push_back(std::move(queued));
+        Logger::init(Config{"config.json"}, std::move(targets));
+
+        // Small records live in the thread's arena; the queue copies into its own resource
+        TaggedLogger t("pmr");
+        t.info(LOG_SRC, "short");
+        assert(global.allocations == 0);
+        assert(queue_resource.live > 0);
+
+        // Records beyond the inline arena take chunks upstream, returned once the record is written
+        t.info(LOG_SRC, "{}", std::string(2 * RecordArena::kInlineBytes, 'x'));
+        assert(global.allocations > 0 && global.live == 0);
+        assert(lines.size() == 2 && lines[1].size() == 5 + 2 * RecordArena::kInlineBytes);
+
+        open = true;
+        Logger::instance().flush();
+        assert(written == 2);
+        Logger::instance().set_targets({});
+    }
+    set_log_memory_resource(nullptr);
+    assert(log_memory_resource() == std::pmr::new_delete_resource());
+}
+
+void test_memory_budget() {
+    MemoryBudget::Options options;
+    options.max_bytes = 1000;
+    options.reserve_bytes = 500;
+    options.report_interval = std::chrono::hours(1);
+    MemoryBudget budget(options);
+    // try_acquire() is what is tested, so it must run outside assert()
+    const bool debug_fits = budget.try_acquire(LogLevel::debug, 400);
+    const bool debug_over = budget.try_acquire(LogLevel::debug, 200);
+    const bool info_fits = budget.try_acquire(LogLevel::info, 200);
+    const bool notice_fits = budget.try_acquire(LogLevel::notice, 200);
+    const bool warning_fits = budget.try_acquire(LogLevel::warning, 200);
+    const bool warning_over = budget.try_acquire(LogLevel::warning, 1);
+    const bool error_fits = budget.try_acquire(LogLevel::error, 400);
+    const bool critical_kept = budget.try_acquire(LogLevel::critical, 200);
+    assert(debug_fits && !debug_over);
+    assert(info_fits && notice_fits && warning_fits && !warning_over);
+    assert(error_fits && critical_kept);
+    assert(budget.used() == 1600);
+    assert(budget.shed(LogLevel::debug) == 1 && budget.shed(LogLevel::warning) == 1);
+    assert(budget.shed(LogLevel::critical) == 0 && budget.overdrawn() == 1);
+    const auto report = budget.take_report();
+    assert(report && report->find("shed 1 DEBUG, 1 WARN records, kept 1 error/critical") != std::string::npos);
+    assert(!budget.take_report());
+    budget.release(1600);
+
+    // Through the logger: debug records are shed by a full queue budget, the report is logged once
+    std::vector<std::string> lines;
+    auto shared = std::make_shared<MemoryBudget>(MemoryBudget::Options{1, 4096, 0.5, 0.7, 0.85,
+                                                                       std::chrono::hours(1)});
+    Logger::Target target{std::make_unique<MemorySink>(lines), std::make_unique<TextFormatter>()};
+    TargetQueue::Options queue_options;
+    queue_options.budget = shared;
+    target.queue = std::make_unique<TargetQueue>(*target.sink, queue_options);
+    std::vector<Logger::Target> targets;
+    targets.push_back(std::move(target));
+    Logger::init(Config{"config.json"}, std::move(targets));
+    assert(Logger::instance().memory_budget() == shared);
+
+    TaggedLogger t("storm");
+    for (int i = 0; i < 3; ++i) {
+        t.debug(LOG_SRC, "noise {}", i);
+    }
+    t.error(LOG_SRC, "kept");
+    t.error(LOG_SRC, "kept too");
+    Logger::instance().flush();
+    assert(shared->shed(LogLevel::debug) == 3);
+    assert(lines.size() == 3);
+    assert(lines[0].rfind("ERROR shed 1 DEBUG records", 0) == 0);
+    assert(lines[1] == "ERROR kept" && lines[2] == "ERROR kept too");
+    assert(shared->used() == 0);
+}
+
+void test_wait_strategies() {
+    for (const auto wait : {BackendOptions::Wait::SPIN, BackendOptions::Wait::SPIN_YIELD,
+                            BackendOptions::Wait::CONDVAR, BackendOptions::Wait::SLEEP}) {
+        std::atomic<bool> open{true};
+        std::atomic<int> written{0};
+        GatedSink sink(open, written);
+        TargetQueue::Options options;
+        options.backend.wait = wait;
+        TargetQueue queue(sink, options);
+        for (int i = 0; i < 50; ++i) {
+            queue.push(Record{LogLevel::info, "wait", LOG_SRC, "test", "record"}, {});
+        }
+        queue.flush();
+        assert(written == 50);
+    }
+}
+
+void test_target_filters() {
+    std::vector<std::string> warnings;
+    std::vector<std::string> console;
+    std::vector<Logger::Target> targets;
+    targets.emplace_back(Logger::Target{std::make_unique<MemorySink>(warnings), std::make_unique<TextFormatter>()});
+    targets.back().filter = TargetFilter({LogLevel::warning, {}, {}, {}, {}});
+    targets.emplace_back(Logger::Target{std::make_unique<MemorySink>(console), std::make_unique<TextFormatter>()});
+    targets.back().filter = TargetFilter({LogLevel::debug, {}, {"metrics"}, {"*basic_tests.cpp"}, {}});
+    Logger::init(Config{"config.json"}, std::move(targets));
+
+    TaggedLogger app("app");
+    TaggedLogger metrics("metrics");
+    app.info(LOG_SRC, "started");
+    app.warning(LOG_SRC, "slow");
+    metrics.warning(LOG_SRC, "queue depth");
+    app.info(SourceLocation{"other.cpp", 1, "f"}, "elsewhere");
+
+    assert((warnings == std::vector<std::string>{"WARN slow", "WARN queue depth"}));
+    assert((console == std::vector<std::string>{"INFO started", "WARN slow"}));
+}
+
+void test_scoped_context() {
+    const auto make = [] { return Record{LogLevel::info, "ctx", LOG_SRC, "test", "handled"}; };
+    assert(!make().context);
+
+    ContextPtr captured;
+    {
+        ScopedContext request{kv("req", 42), kv("user", "bob")};
+        {
+            ScopedContext inner{kv("user", "alice"), kv("retry", true)};
+            const auto rec = make();
+            assert(rec.context->text() == "req=42 user=alice retry=true");
+            const auto j = nlohmann::json::parse(JsonFormatter().format(rec));
+            assert(j["context"]["req"] == 42 && j["context"]["retry"] == true);
+            assert(j["message"] == "handled");
+        }
+        captured = current_context();
+        assert(TextFormatter().format(make()).find("handled {req=42 user=bob}, SOURCE") != std::string::npos);
+    }
+    assert(!current_context());
+
+    std::string text;
+    std::thread pool([&] {
+        ScopedContext restore{captured};
+        text = make().context->text();
+    });
+    pool.join();
+    assert(text == "req=42 user=bob");
+
+    // Invalid UTF-8 in a value is replaced in the JSON view rather than throwing
+    ScopedContext bad{kv("k", "bad \xff")};
+    const auto j = nlohmann::json::parse(make().context->json());
+    assert(j["k"] == "bad \xef\xbf\xbd");
+}
+
+void test_log_batch() {
+    auto sink = std::make_unique<BatchCountingSink>();
+    auto* counting = sink.get();
+    Config cfg{"config.json"};
+    cfg.level = LogLevel::info;
+    std::vector<Logger::Target> targets;
+    targets.emplace_back(Logger::Target{std::move(sink), std::make_unique<TextFormatter>()});
+    Logger::init(cfg, std::move(targets));
+
+    const auto tag = TagRegistry::intern("etl");
+    {
+        auto b = Logger::instance().batch(tag);
+        for (int i = 0; i < 5; ++i) {
+            b.info(LOG_SRC, "row {}", i);
+            b.debug(LOG_SRC, "filtered {}", i);
+        }
+        assert(b.pending() == 5 && counting->lines.empty());
+        b.commit();
+        assert(b.pending() == 0);
+
+        b.warning(LOG_SRC, "committed on scope exit");
+    }
+    assert((counting->batch_sizes == std::vector<std::size_t>{5, 1}));
+    assert(counting->lines.size() == 6);
+    assert(counting->lines[0].find("row 0") != std::string::npos);
+    assert(counting->lines[0].find("[etl]") != std::string::npos);
+    assert(counting->lines[4].find("row 4") != std::string::npos);
+
+    LogBatch small(Logger::instance(), tag, 2);
+    small.info(LOG_SRC, "a");
+    small.info(LOG_SRC, "b");
+    small.info(LOG_SRC, "c");
+    assert(small.pending() == 1);
+    assert(counting->batch_sizes.back() == 2);
+}
+
+void test_spans() {
+    auto sink = std::make_unique<BatchCountingSink>();
+    auto* counting = sink.get();
+    std::vector<Logger::Target> targets;
+    targets.emplace_back(Logger::Target{std::move(sink), std::make_unique<TraceEventFormatter>()});
+    Config cfg{"config.json"};
+    cfg.level = LogLevel::info;
+    Logger::init(cfg, std::move(targets));
+
+    TaggedLogger db("db");
+    {
+        DAWGLOG_SPAN(db, "load");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        assert(counting->lines.empty());
+    }
+    {
+        ScopedSpan hidden(db, "hidden", LOG_SRC, LogLevel::debug);
+    }
+    TAG_INFO(db, "loaded");
+    assert(counting->lines.size() == 2);
+
+    const auto span = nlohmann::json::parse(counting->lines[0]);
+    assert(span["ph"] == "X" && span["name"] == "load" && span["cat"] == "db");
+    assert(span["dur"].get<double>() >= 2000.0);
+    const auto instant = nlohmann::json::parse(counting->lines[1]);
+    assert(instant["ph"] == "i" && instant["args"]["message"] == "loaded");
+    assert(instant["ts"].get<double>() >= span["ts"].get<double>() + span["dur"].get<double>());
+}
+
+void test_static_logger() {
+    std::vector<std::string> lines;
+    using TestLogger = StaticLogger<StaticTarget<MemorySink, TextFormatter>,
+                                    StaticTarget<BatchCountingSink, JsonFormatter>>;
+    TestLogger logger{"static", std::forward_as_tuple(lines), std::tuple<>{}};
+    logger.set_level(LogLevel::info);
+    logger.target<1>().filter = TargetFilter({LogLevel::warning, {}, {}, {}, {}});
+
+    auto net = logger.tagged("static-net");
+    TAG_DEBUG(net, "hidden {}", 1);
+    TAG_INFO(net, "connected to {}", "db");
+    TAG_WARNING(net, "slow");
+    assert((lines == std::vector<std::string>{"INFO connected to db", "WARN slow"}));
+
+    const auto& json_lines = logger.target<1>().sink().lines;
+    assert(json_lines.size() == 1);
+    const auto j = nlohmann::json::parse(json_lines[0]);
+    assert(j["message"] == "slow" && j["tag"] == "static-net" && j["app_name"] == "static");
+
+    TagRegistry::set_level(net.interned_tag().id, LogLevel::debug);
+    TAG_DEBUG(net, "shown");
+    TagRegistry::set_level(net.interned_tag().id, std::nullopt);
+    assert(lines.back() == "DEBUG shown");
+}
+
+void test_thread_fields() {
+    const Record main_rec{LogLevel::info, "thread", LOG_SRC, "test", "main"};
+    std::string formatted;
+    std::string json;
+    std::uint32_t worker_id = 0;
+    std::thread worker([&] {
+        set_thread_name("dl-worker");
+        const Record rec{LogLevel::info, "thread", LOG_SRC, "test", "worker"};
+        worker_id = rec.thread_id;
+        assert(rec.thread_name == "dl-worker");
+        assert(rec.mono_ns >= main_rec.mono_ns);
+        assert(rec.cpu >= 0);
+        formatted = TextFormatter(true).format(rec);
+        json = JsonFormatter(true).format(rec);
+    });
+    worker.join();
+    assert(main_rec.thread_id == current_thread().id);
+    assert(worker_id != 0 && worker_id != main_rec.thread_id);
+    assert(formatted.find(", THREAD: " + std::to_string(worker_id) + "(dl-worker) CPU: ") != std::string::npos);
+
+    const auto j = nlohmann::json::parse(json);
+    assert(j["tid"] == worker_id && j["thread"] == "dl-worker" && j.contains("cpu") && j.contains("mono_ns"));
+    const auto plain = nlohmann::json::parse(JsonFormatter().format(main_rec));
+    assert(!plain.contains("tid") && !plain.contains("thread") && !plain.contains("cpu") && !plain.contains("mono_ns"));
+}
+}
+
 int main() {
     Logger::init(Config{"config.json"});
     TaggedLogger t("mod");
     t.info(LOG_SRC, "value {}", 123);
     assert(true);
+
+    test_config_sink_options();
+    test_flight_recorder();
+    test_lazy_macros();
+    test_bytes();
+    test_tag_levels();
+    test_target_queue();
+    test_format_workers();
+    test_memory_resource();
+    test_wait_strategies();
+    test_memory_budget();
+    test_target_filters();
+    test_thread_fields();
+    test_scoped_context();
+    test_log_batch();
+    test_spans();
+    test_static_logger();
     return 0;
 }
@@ -0,0 +1,528 @@
+#include "dawg-log/logger.hpp"
+#include "dawg-log/formatters/json_formatter.hpp"
+#include "dawg-log/formatters/text_formatter.hpp"
+#include "dawg-log/sinks/archive_sink.hpp"
+#include "dawg-log/sinks/file_sink.hpp"
+#include "dawg-log/sinks/journald_sink.hpp"
+#include "dawg-log/sinks/network_sink.hpp"
+#include "dawg-log/sinks/sharded_file_sink.hpp"
+#include "dawg-log/sinks/trace_file_sink.hpp"
+#include "dawg-log/shard_file.hpp"
+#include "dawg-log/sinks/shm_sink.hpp"
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+
+#ifdef DAWGLOG_HAS_ZLIB
+#include "dawg-log/sinks/compressed_file_sink.hpp"
+#endif
+
+using namespace DawgLog;
+
+namespace {
+// Keeps the formatted text; like most sinks, it leaves the payload to the formatter
+struct TextSink : Sink {
+    void write(const Record&, std::string_view formatted) override {
+        lines.emplace_back(formatted);
+    }
+
+    std::vector<std::string> lines;
+};
+
+void test_archive_sink() {
+    const std::string path = std::filesystem::temp_directory_path() /
+                             ("dawglog_archive_" + std::to_string(::getpid()) + ".dla");
+    std::filesystem::remove(path);
+    {
+        ArchiveSink sink(path, 256);
+        for (int i = 0; i < 40; ++i) {
+            const auto lvl = i % 10 == 0 ? LogLevel::error : LogLevel::debug;
+            Record r{lvl, i < 20 ? "db" : "net", LOG_SRC, "test", "request " + std::to_string(i) + " done"};
+            sink.write(r, r.message);
+        }
+    }
+    const ArchiveReader reader(path);
+    assert(reader.is_open());
+    assert(reader.blocks().size() > 1);
+
+    std::size_t records = 0;
+    std::size_t errors = 0;
+    for (const auto& block : reader.blocks()) {
+        records += block.header.records;
+        if ((block.header.level_mask & archive_level_bit(LogLevel::error)) == 0) {
+            continue;
+        }
+        const bool intact = block.for_each_record([&](const ArchiveRecord& rec) {
+            errors += rec.level == LogLevel::error ? 1 : 0;
+        });
+        assert(intact);
+    }
+    assert(records == 40);
+    assert(errors == 4);
+
+    const auto& first = reader.blocks().front();
+    assert(first.has_tag(archive_tag_id("db")));
+    assert(!first.has_tag(archive_tag_id("net")));
+    assert(archive_bloom_may_contain(first.bloom, "request"));
+    assert(archive_required_tokens("st 7 do", false) == std::vector<std::string>{"7"});
+    std::filesystem::remove(path);
+}
+
+#ifdef DAWGLOG_HAS_ZLIB
+void test_compressed_file_sink() {
+    const std::string path = std::filesystem::temp_directory_path() /
+                             ("dawglog_compressed_" + std::to_string(::getpid()) + ".log.gz");
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".idx");
+    {
+        CompressedFileSink sink(path, 64);
+        for (int i = 0; i < 20; ++i) {
+            Record r{LogLevel::info, "zip", LOG_SRC, "test", "line " + std::to_string(i)};
+            sink.write(r, r.message);
+        }
+    }
+    const auto index = CompressedFileSink::read_index(path);
+    assert(index.size() > 1);
+    assert(index.front().offset == 0);
+    assert(index.back().offset + index.back().compressed_size == std::filesystem::file_size(path));
+
+    const auto now = std::chrono::system_clock::now();
+    const auto text = CompressedFileSink::read_range(path, now - std::chrono::minutes(1), now);
+    assert(text.find("line 0\n") != std::string::npos);
+    assert(text.find("line 19\n") != std::string::npos);
+    assert(CompressedFileSink::read_range(path, now + std::chrono::hours(1), now + std::chrono::hours(2)).empty());
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".idx");
+}
+#endif
+
+void test_network_sink() {
+    const std::string spool = std::filesystem::temp_directory_path() /
+                              ("dawglog_network_" + std::to_string(::getpid()) + ".spool");
+    std::filesystem::remove(spool);
+
+    // Bound but not listening: connection attempts are refused until listen()
+    const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    const int bound = ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    assert(bound == 0);
+    socklen_t len = sizeof(addr);
+    ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len);
+
+    NetworkSink::Options options;
+    options.port = ntohs(addr.sin_port);
+    options.framing = NetworkSink::Framing::OCTET_COUNTING;
+    options.spool_path = spool;
+    options.reconnect_min = std::chrono::milliseconds(10);
+    options.reconnect_max = std::chrono::milliseconds(50);
+    NetworkSink sink(options);
+
+    const auto send = [&](const std::string& msg) {
+        Record r{LogLevel::info, "net", LOG_SRC, "test", msg};
+        sink.write(r, r.message);
+    };
+    send("down 0");
+    send("down 1");
+    sink.flush();
+    assert(!sink.connected());
+    assert(std::filesystem::file_size(spool) > 0);
+
+    const int listening = ::listen(listener, 1);
+    assert(listening == 0);
+    pollfd pfd{listener, POLLIN, 0};
+    const int ready = ::poll(&pfd, 1, 5000);
+    assert(ready == 1);
+    const int conn = ::accept(listener, nullptr, nullptr);
+    send("up 0");
+    sink.flush();
+
+    const std::string expected = "6 down 06 down 14 up 0";
+    std::string received;
+    pollfd cfd{conn, POLLIN, 0};
+    while (received.size() < expected.size() && ::poll(&cfd, 1, 5000) == 1) {
+        char buf[256];
+        const auto n = ::read(conn, buf, sizeof(buf));
+        if (n <= 0) {
+            break;
+        }
+        received.append(buf, static_cast<std::size_t>(n));
+    }
+    assert(received == expected);
+    assert(sink.dropped() == 0);
+    ::close(conn);
+    ::close(listener);
+    std::filesystem::remove(spool);
+}
+
+// Parses a native journal protocol entry into its fields
+std::map<std::string, std::string> parse_journal_entry(std::string_view data) {
+    std::map<std::string, std::string> fields;
+    while (!data.empty()) {
+        const auto end = data.find('\n');
+        const auto line = data.substr(0, end);
+        const auto eq = line.find('=');
+        if (eq != std::string_view::npos) {
+            fields[std::string(line.substr(0, eq))] = std::string(line.substr(eq + 1));
+            data.remove_prefix(end + 1);
+            continue;
+        }
+        std::uint64_t size = 0;
+        for (int i = 0; i < 8; ++i) {
+            size |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[end + 1 + i])) << (8 * i);
+        }
+        fields[std::string(line)] = std::string(data.substr(end + 9, size));
+        data.remove_prefix(end + 9 + size + 1);
+    }
+    return fields;
+}
+
+void test_journald_sink() {
+    const std::string path = std::filesystem::temp_directory_path() /
+                             ("dawglog_journal_" + std::to_string(::getpid()));
+    std::filesystem::remove(path);
+    const int server = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    const int bound = ::bind(server, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    assert(bound == 0);
+
+    // Receives one datagram; the content of a passed memfd replaces the (empty) payload
+    const auto receive = [server] {
+        std::string buf(64 * 1024, '\0');
+        iovec iov{buf.data(), buf.size()};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        const auto n = ::recvmsg(server, &msg, 0);
+        assert(n >= 0);
+        buf.resize(static_cast<std::size_t>(n));
+        if (const cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr && cmsg->cmsg_type == SCM_RIGHTS) {
+            int fd = -1;
+            std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+            assert(n == 0);
+            assert((::fcntl(fd, F_GET_SEALS) & F_SEAL_WRITE) != 0);
+            const auto size = ::lseek(fd, 0, SEEK_END);
+            buf.resize(static_cast<std::size_t>(size));
+            const auto read = ::pread(fd, buf.data(), buf.size(), 0);
+            assert(read == size);
+            ::close(fd);
+        }
+        return parse_journal_entry(buf);
+    };
+
+    JournaldSink sink("test", path);
+    assert(!sink.needs_formatting());
+    {
+        ScopedContext ctx{kv("req", 42), kv("user.name", "bob")};
+        Record r{LogLevel::warning, "net", SourceLocation{"net.cpp", 17, "connect"}, "test", "link\ndown"};
+        sink.write(r, {});
+    }
+    auto fields = receive();
+    assert(fields["MESSAGE"] == "link\ndown");
+    assert(fields["PRIORITY"] == "4");
+    assert(fields["SYSLOG_IDENTIFIER"] == "test");
+    assert(fields["DAWGLOG_TAG"] == "net");
+    assert(fields["CODE_FILE"] == "net.cpp");
+    assert(fields["CODE_LINE"] == "17");
+    assert(fields["CODE_FUNC"] == "connect");
+    assert(fields["REQ"] == "42");
+    assert(fields["USER_NAME"] == "bob");
+    assert(!fields["TID"].empty());
+
+    // Larger than any datagram the socket accepts: goes through a sealed memfd
+    const std::string large(1 << 20, 'x');
+    Record big{LogLevel::error, "net", LOG_SRC, "test", large};
+    sink.write(big, {});
+    fields = receive();
+    assert(fields["MESSAGE"] == large);
+    assert(fields["PRIORITY"] == "3");
+
+    // Payloads use the binary field form and, from 64 KiB, the memfd
+    std::string body(100 * 1024, 'p');
+    body[10] = '\n';
+    Record upload{LogLevel::info, "net", LOG_SRC, "test", "upload"};
+    upload.payload = body;
+    sink.write(upload, {});
+    fields = receive();
+    assert(fields["MESSAGE"] == "upload");
+    assert(fields["PAYLOAD"] == body);
+
+    ::close(server);
+    std::filesystem::remove(path);
+}
+
+void test_payload() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string text_path = dir / "dawglog_payload.log";
+    const std::string json_path = dir / "dawglog_payload.json";
+    const std::string queued_path = dir / "dawglog_payload_queued.log";
+    for (const auto& path : {text_path, json_path, queued_path}) {
+        std::filesystem::remove(path);
+    }
+    TextSink* worker_sink = nullptr;
+    {
+        std::vector<Logger::Target> targets;
+        targets.emplace_back(Logger::Target{std::make_unique<FileSink>(text_path), std::make_unique<TextFormatter>()});
+        targets.emplace_back(Logger::Target{std::make_unique<FileSink>(json_path), std::make_unique<JsonFormatter>()});
+        Logger::Target queued{std::make_unique<FileSink>(queued_path), std::make_unique<TextFormatter>()};
+        queued.queue = std::make_unique<TargetQueue>(*queued.sink, TargetQueue::Options{});
+        targets.push_back(std::move(queued));
+        // Formatted by the queue's format workers, which append the payload for the sink
+        Logger::Target workers{std::make_unique<TextSink>(), std::make_unique<TextFormatter>()};
+        TargetQueue::Options worker_options;
+        worker_options.format_workers = 2;
+        workers.queue = std::make_unique<TargetQueue>(*workers.sink, worker_options, workers.formatter.get());
+        assert(workers.queue->formats_records());
+        worker_sink = static_cast<TextSink*>(workers.sink.get());
+        targets.push_back(std::move(workers));
+        Logger::init(Config{"config.json"}, std::move(targets));
+    }
+
+    std::string body(64 * 1024, ' ');
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        body[i] = static_cast<char>('a' + i % 26);
+    }
+    TaggedLogger t("gateway");
+    {
+        std::string borrowed = body;
+        t.payload(LogLevel::info, LOG_SRC, borrowed, "POST {} -> {}", "/upload", 201);
+        // The queue has its own copy; the caller's buffer may go away right after the call
+        borrowed.assign(borrowed.size(), '!');
+    }
+    Logger::instance().flush();
+    const auto worker_lines = worker_sink->lines;
+    Logger::instance().set_targets({});
+
+    const auto read_line = [](const std::string& path) {
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line);
+        return line;
+    };
+    const auto text = read_line(text_path);
+    assert(text.find("[gateway] INFO: POST /upload -> 201") != std::string::npos);
+    assert(text.ends_with(", PAYLOAD(65536): " + body));
+    assert(read_line(queued_path) == text);
+    assert(worker_lines.size() == 1 && worker_lines[0] == text);
+    const auto j = nlohmann::json::parse(read_line(json_path));
+    assert(j["message"] == "POST /upload -> 201");
+    assert(j["payload"] == body);
+    for (const auto& path : {text_path, json_path, queued_path}) {
+        std::filesystem::remove(path);
+    }
+}
+
+std::size_t open_fds() {
+    const std::filesystem::directory_iterator fds("/proc/self/fd");
+    return static_cast<std::size_t>(std::distance(begin(fds), end(fds)));
+}
+
+void test_sharded_file_sink() {
+    const std::string prefix = (std::filesystem::temp_directory_path() / "dawglog_sharded").string();
+    std::vector<std::string> paths;
+    {
+        ShardedFileSink sink(prefix, 256);
+        const auto fds_before = open_fds();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&sink, t] {
+                for (int i = 0; i < 100; ++i) {
+                    Record r{LogLevel::info, "shard", LOG_SRC, "test", "record"};
+                    sink.write(r, "thread " + std::to_string(t) + " record " + std::to_string(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        // Shards of exited threads are closed while the sink lives on
+        const auto fds_after = open_fds();
+        assert(fds_after == fds_before);
+        paths = sink.shard_paths();
+    }
+    assert(paths.size() == 4);
+
+    std::size_t total = 0;
+    for (const auto& path : paths) {
+        ShardFileReader reader(path);
+        assert(reader.is_open() && reader.pid() == static_cast<std::uint32_t>(::getpid()));
+        ShardRecord rec;
+        std::uint64_t last_mono = 0;
+        std::string owner;
+        for (std::uint64_t seq = 0; reader.next(rec); ++seq, ++total) {
+            assert(rec.seq == seq && rec.mono_ns >= last_mono);
+            last_mono = rec.mono_ns;
+            const auto thread = std::string(rec.text.substr(0, rec.text.find(" record")));
+            assert(owner.empty() || owner == thread);
+            owner = thread;
+            assert(rec.text == owner + " record " + std::to_string(seq));
+        }
+        std::filesystem::remove(path);
+    }
+    assert(total == 400);
+}
+
+void test_trace_file_sink() {
+    const std::string path = (std::filesystem::temp_directory_path() / "dawglog_trace.json").string();
+    {
+        TraceFileSink sink(path);
+        Record span{LogLevel::info, "db", LOG_SRC, "test", "query"};
+        span.span_ns = 1500;
+        sink.write(span, {});
+        sink.write(Record{LogLevel::warning, "db", LOG_SRC, "test", "slow"}, {});
+        // Invalid UTF-8 is replaced, as by the JSON formatter, instead of throwing
+        Record bad{LogLevel::info, "db", LOG_SRC, "test", "bad \xff byte"};
+        bad.thread_id = 424242;
+        bad.thread_name = "worker\xff";
+        sink.write(bad, {});
+    }
+    std::ifstream in(path);
+    const auto all = nlohmann::json::parse(in);
+    assert(all.is_array());
+    // Skip the thread_name metadata event of the named main thread
+    std::vector<nlohmann::json> events;
+    bool replaced_name = false;
+    for (const auto& event : all) {
+        if (event["ph"] != "M") {
+            events.push_back(event);
+        } else if (event["tid"] == 424242) {
+            replaced_name = event["args"]["name"] == "worker\xef\xbf\xbd";
+        }
+    }
+    assert(replaced_name);
+    assert(events.size() == 3);
+    assert(events[2]["args"]["message"] == "bad \xef\xbf\xbd byte");
+    assert(events[0]["ph"] == "X" && events[0]["dur"] == 1.5);
+    assert(events[1]["ph"] == "i" && events[1]["args"]["level"] == "WARN");
+    std::filesystem::remove(path);
+}
+
+void test_shm_sink() {
+    const std::string name = "/dawglog_sink_tests_" + std::to_string(::getpid());
+    ShmSink sink(name, "test", 4, 256);
+    for (int i = 0; i < 6; ++i) {
+        Record r{LogLevel::warning, "shm", LOG_SRC, "test", "record " + std::to_string(i)};
+        sink.write(r, {});
+    }
+    assert(sink.overruns() == 2);
+
+    ShmRingReader reader(name);
+    assert(reader.is_open());
+    assert(reader.app_name() == "test");
+    ShmRecord rec;
+    for (int i = 0; i < 4; ++i) {
+        const bool got = reader.next(rec);
+        assert(got);
+        assert(rec.message == "record " + std::to_string(i));
+        assert(rec.tag == "shm" && rec.level == LogLevel::warning);
+    }
+    const bool more = reader.next(rec);
+    assert(!more);
+
+    // A producer that died after claiming a slot: the reader skips it once the PID is gone
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    auto* header = static_cast<ShmRingHeader*>(
+        ::mmap(nullptr, sizeof(ShmRingHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    ::close(fd);
+    header->enqueue_pos.fetch_add(1);
+    Record after{LogLevel::info, "shm", LOG_SRC, "test", "after crash"};
+    sink.write(after, {});
+    const bool past_claimed = reader.next(rec);
+    assert(!past_claimed);
+
+    const pid_t child = ::fork();
+    if (child == 0) {
+        ::_exit(0);
+    }
+    ::waitpid(child, nullptr, 0);
+    const auto producer = header->producer_pid;
+    header->producer_pid = child;
+    const bool skipped = reader.next(rec);
+    assert(skipped);
+    assert(rec.message == "after crash");
+    assert(reader.torn() == 1);
+    header->producer_pid = producer;
+
+    ::munmap(header, sizeof(ShmRingHeader));
+    ::shm_unlink(name.c_str());
+
+    // Payloads follow the message in the slot and are cut like it
+    const std::string payload_name = name + "_payload";
+    {
+        ShmSink payload_sink(payload_name, "test", 4, 256);
+        assert(payload_sink.writes_payload());
+        Record small{LogLevel::info, "shm", LOG_SRC, "test", "upload"};
+        small.payload = "0123456789";
+        payload_sink.write(small, {});
+        const std::string large(1000, 'x');
+        Record big{LogLevel::info, "shm", LOG_SRC, "test", "upload"};
+        big.payload = large;
+        payload_sink.write(big, {});
+    }
+    ShmRingReader payload_reader(payload_name);
+    const bool got_small = payload_reader.next(rec);
+    assert(got_small);
+    assert(rec.message == "upload" && rec.payload == "0123456789" && !rec.truncated);
+    const bool got_big = payload_reader.next(rec);
+    assert(got_big);
+    assert(rec.message == "upload" && rec.truncated);
+    assert(!rec.payload.empty() && rec.payload.size() < 1000 && rec.payload.find_first_not_of('x') == std::string::npos);
+    ::shm_unlink(payload_name.c_str());
+
+    // Records forwarded by the agent may wait in a queue after the reader buffer is reused
+    std::vector<Logger::Target> targets;
+    Logger::Target queued{std::make_unique<TextSink>(), std::make_unique<TextFormatter>()};
+    queued.queue = std::make_unique<TargetQueue>(*queued.sink, TargetQueue::Options{});
+    auto* queued_sink = static_cast<TextSink*>(queued.sink.get());
+    targets.push_back(std::move(queued));
+    Logger::init(Config{"config.json"}, std::move(targets));
+    {
+        std::string file = "src/producer.cpp";
+        ShmRecord in;
+        in.tag = "shm";
+        in.file = file;
+        in.line = 12;
+        in.message = "forwarded";
+        Logger::instance().write(to_record(in, "producer"));
+        file.assign(file.size(), '#');
+    }
+    Logger::instance().flush();
+    assert(queued_sink->lines.size() == 1);
+    assert(queued_sink->lines[0].find("SOURCE: src/producer.cpp:12") != std::string::npos);
+    Logger::instance().set_targets({});
+}
+}
+
+int main() {
+    test_archive_sink();
+    test_network_sink();
+    test_shm_sink();
+    test_journald_sink();
+    test_payload();
+    test_sharded_file_sink();
+    test_trace_file_sink();
+#ifdef DAWGLOG_HAS_ZLIB
+    test_compressed_file_sink();
+#endif
+    return 0;
+}
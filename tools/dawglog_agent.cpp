@@ -0,0 +1,115 @@
+// dawglog-agent: write the records of a ShmSink segment to the configured targets
+//
+// usage: dawglog-agent [--config FILE] [--name NAME] [--drain]
+//
+// The agent maps the shared-memory ring created by ShmSink, formats the records and
+// writes them with the targets of the logger configuration, so the producing
+// application does no I/O. Overruns (records the producer dropped because the ring
+// was full) and torn slots (the producer died while writing) are reported as
+// warnings with the tag "dawglog-agent". When the producer restarts, the agent
+// drains the old segment and then switches to the new one.
+#include <dawg-log/logger.hpp>
+#include <dawg-log/shm_ring.hpp>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace dog = DawgLog;
+
+namespace {
+std::atomic<bool> stop{false};
+
+int usage() {
+    std::cerr << "usage: dawglog-agent [--config FILE] [--name NAME] [--drain]\n"
+                 "  --config  logger configuration with the output targets (default config.json)\n"
+                 "  --name    shared-memory segment of the shm sink (default /dawglog)\n"
+                 "  --drain   exit once the producer has exited and the ring is empty\n";
+    return 2;
+}
+
+void forward(const dog::ShmRingReader& reader, const dog::ShmRecord& in) {
+    dog::Logger::instance().write(dog::to_record(in, reader.app_name()));
+}
+}
+
+int main(int argc, char** argv) {
+    std::string config_path = "config.json";
+    std::string name = "/dawglog";
+    bool drain = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (arg == "--name" && i + 1 < argc) {
+            name = argv[++i];
+        } else if (arg == "--drain") {
+            drain = true;
+        } else {
+            return usage();
+        }
+    }
+
+    std::signal(SIGINT, [](int) { stop = true; });
+    std::signal(SIGTERM, [](int) { stop = true; });
+    dog::Logger::init(dog::Config{config_path});
+    dog::TaggedLogger agent("dawglog-agent");
+
+    std::unique_ptr<dog::ShmRingReader> reader;
+    std::uint64_t reported_overruns = 0;
+    std::uint64_t reported_torn = 0;
+    auto next_report = std::chrono::steady_clock::now();
+    while (!stop) {
+        if (!reader || !reader->is_open()) {
+            reader = std::make_unique<dog::ShmRingReader>(name);
+            if (!reader->is_open()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            reported_overruns = 0;
+            reported_torn = 0;
+        }
+
+        // Sampled before reading: if the producer was already gone, this pass sees all its records
+        const bool producer_alive = reader->producer_alive();
+        dog::ShmRecord rec;
+        std::size_t batch = 0;
+        while (batch < 4096 && reader->next(rec)) {
+            forward(*reader, rec);
+            ++batch;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const bool idle = batch == 0;
+        if (idle || now >= next_report) {
+            if (const auto overruns = reader->overruns(); overruns > reported_overruns) {
+                agent.warning(LOG_SRC, "ring full, producer dropped {} records", overruns - reported_overruns);
+                reported_overruns = overruns;
+            }
+            if (reader->torn() > reported_torn) {
+                agent.warning(LOG_SRC, "producer died while writing, skipped {} torn records",
+                              reader->torn() - reported_torn);
+                reported_torn = reader->torn();
+            }
+            next_report = now + std::chrono::seconds(1);
+        }
+        if (!idle) {
+            continue;
+        }
+        if (!producer_alive) {
+            if (drain) {
+                break;
+            }
+            if (reader->replaced()) {
+                reader.reset();
+                continue;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(producer_alive ? 1 : 100));
+    }
+    dog::Logger::instance().flush();
+    return 0;
+}
@@ -0,0 +1,173 @@
+// dawglog-merge: merge the shard files of a ShardedFileSink into one ordered stream
+//
+// usage: dawglog-merge [--level LEVEL] [--seq] [-o FILE] SHARD...
+//
+// A k-way merge on the monotonic timestamp (ties broken by shard and sequence number)
+// produces the global order while reading each mapped shard front to back once. Shards
+// are usually ordered, but a flight-recorder dump or a LogBatch commit appends records
+// stamped earlier than the ones before them; such a shard is detected by a first pass
+// and its records are sorted (stably, keeping sequence order on ties) before the merge.
+#include <dawg-log/shard_file.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <fmt/format.h>
+
+namespace dog = DawgLog;
+
+namespace {
+int usage() {
+    std::cerr << "usage: dawglog-merge [--level LEVEL] [--seq] [-o FILE] SHARD...\n"
+                 "  --level  minimum level (debug, info, notice, warning, error, critical)\n"
+                 "  --seq    prefix every line with <shard>:<sequence>\n"
+                 "  -o       write to FILE instead of stdout\n";
+    return 2;
+}
+
+// Records of one shard, streamed from the mapping or, for an unordered shard, sorted up front
+struct Shard {
+    std::unique_ptr<dog::ShardFileReader> reader;
+    std::optional<std::vector<dog::ShardRecord>> sorted;
+    std::size_t pos{0};
+
+    bool next(dog::ShardRecord& rec) {
+        if (!sorted) {
+            return reader->next(rec);
+        }
+        if (pos == sorted->size()) {
+            return false;
+        }
+        rec = (*sorted)[pos++];
+        return true;
+    }
+};
+
+bool ordered_by_time(const std::string& path) {
+    dog::ShardFileReader reader(path);
+    dog::ShardRecord rec;
+    std::uint64_t last_mono = 0;
+    while (reader.next(rec)) {
+        if (rec.mono_ns < last_mono) {
+            return false;
+        }
+        last_mono = rec.mono_ns;
+    }
+    return true;
+}
+
+struct Head {
+    std::uint64_t mono_ns;
+    std::uint32_t shard;
+    std::uint64_t seq;
+    std::size_t reader;
+
+    bool operator>(const Head& other) const {
+        return std::tie(mono_ns, shard, seq) > std::tie(other.mono_ns, other.shard, other.seq);
+    }
+};
+}
+
+int main(int argc, char** argv) {
+    std::optional<dog::LogLevel> min_level;
+    bool with_seq = false;
+    std::string output;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--level" || arg == "-o") {
+            if (i + 1 >= argc) {
+                return usage();
+            }
+            const std::string value = argv[++i];
+            if (arg == "-o") {
+                output = value;
+                continue;
+            }
+            dog::LogLevel level;
+            if (!dog::parse_level(value, level)) {
+                std::cerr << "Unknown level '" << value << "'" << std::endl;
+                return usage();
+            }
+            min_level = level;
+        } else if (arg == "--seq") {
+            with_seq = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            return usage();
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        return usage();
+    }
+
+    FILE* out = stdout;
+    if (!output.empty()) {
+        out = std::fopen(output.c_str(), "w");
+        if (out == nullptr) {
+            std::cerr << "Failed to open output file: " << output << std::endl;
+            return 1;
+        }
+    }
+    static char out_buffer[1 << 20];
+    std::setvbuf(out, out_buffer, _IOFBF, sizeof(out_buffer));
+
+    std::vector<Shard> shards;
+    std::vector<dog::ShardRecord> current;
+    std::priority_queue<Head, std::vector<Head>, std::greater<>> heads;
+    const auto advance = [&](std::size_t i) {
+        auto& rec = current[i];
+        while (shards[i].next(rec)) {
+            if (!min_level || rec.level >= *min_level) {
+                heads.push(Head{rec.mono_ns, shards[i].reader->shard(), rec.seq, i});
+                return;
+            }
+        }
+    };
+    for (const auto& file : files) {
+        Shard shard{std::make_unique<dog::ShardFileReader>(file)};
+        if (!shard.reader->is_open()) {
+            continue;
+        }
+        if (!ordered_by_time(file)) {
+            auto& records = shard.sorted.emplace();
+            dog::ShardRecord rec;
+            while (shard.reader->next(rec)) {
+                records.push_back(rec);
+            }
+            std::stable_sort(records.begin(), records.end(),
+                             [](const auto& a, const auto& b) { return a.mono_ns < b.mono_ns; });
+        }
+        shards.push_back(std::move(shard));
+    }
+    current.resize(shards.size());
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        advance(i);
+    }
+
+    while (!heads.empty()) {
+        const auto head = heads.top();
+        heads.pop();
+        const auto& rec = current[head.reader];
+        if (with_seq) {
+            fmt::print(out, "{}:{} ", head.shard, rec.seq);
+        }
+        std::fwrite(rec.text.data(), 1, rec.text.size(), out);
+        std::fputc('\n', out);
+        advance(head.reader);
+    }
+
+    if (out != stdout) {
+        std::fclose(out);
+    } else {
+        std::fflush(out);
+    }
+    return shards.size() == files.size() ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+// dawglog-query: filter records of dawg-log archives (see ArchiveSink)
+//
+// usage: dawglog-query [--from MS] [--to MS] [--level LEVEL] [--tag TAG]
+//                      [--grep TEXT] [-w] [--threads N] FILE...
+//
+// Block metadata (time range, level bitmap, tag IDs, token bloom filter) is used
+// to skip blocks; the remaining candidate blocks are scanned in parallel and the
+// matching lines are printed in file order.
+#include <dawg-log/archive.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dog = DawgLog;
+
+namespace {
+struct Query {
+    std::int64_t from_ms{std::numeric_limits<std::int64_t>::min()};
+    std::int64_t to_ms{std::numeric_limits<std::int64_t>::max()};
+    std::uint32_t level_mask{~0u};
+    std::optional<std::string> tag;
+    std::optional<std::string> text;
+    bool whole_words{false};
+    unsigned threads{std::max(1u, std::thread::hardware_concurrency())};
+};
+
+int usage() {
+    std::cerr << "usage: dawglog-query [--from MS] [--to MS] [--level LEVEL] [--tag TAG]\n"
+                 "                     [--grep TEXT] [-w] [--threads N] FILE...\n"
+                 "  --from/--to  inclusive time range in milliseconds since the epoch\n"
+                 "  --level      minimum level (debug, info, notice, warning, error, critical)\n"
+                 "  --tag        only records with this tag\n"
+                 "  --grep       only lines containing TEXT (-w: TEXT consists of whole words)\n";
+    return 2;
+}
+
+bool block_may_match(const dog::ArchiveBlock& block, const Query& q, std::uint32_t tag_id,
+                     const std::vector<std::string>& tokens) {
+    if (block.header.max_ms < q.from_ms || block.header.min_ms > q.to_ms) {
+        return false;
+    }
+    if ((block.header.level_mask & q.level_mask) == 0) {
+        return false;
+    }
+    if (q.tag && !block.has_tag(tag_id)) {
+        return false;
+    }
+    return std::all_of(tokens.begin(), tokens.end(), [&](const std::string& token) {
+        return dog::archive_bloom_may_contain(block.bloom, token);
+    });
+}
+
+void scan_block(const dog::ArchiveBlock& block, const Query& q, std::uint32_t tag_id, std::string& out) {
+    block.for_each_record([&](const dog::ArchiveRecord& rec) {
+        if (rec.time_ms < q.from_ms || rec.time_ms > q.to_ms) {
+            return;
+        }
+        if ((dog::archive_level_bit(rec.level) & q.level_mask) == 0) {
+            return;
+        }
+        if (q.tag && (rec.tag_id != tag_id || rec.tag != *q.tag)) {
+            return;
+        }
+        if (q.text && rec.line.find(*q.text) == std::string_view::npos) {
+            return;
+        }
+        out.append(rec.line);
+        out.push_back('\n');
+    });
+}
+
+void query_file(const std::string& path, const Query& q) {
+    const dog::ArchiveReader reader(path);
+    if (!reader.is_open()) {
+        return;
+    }
+    const auto tag_id = q.tag ? dog::archive_tag_id(*q.tag) : 0;
+    const auto tokens = q.text ? dog::archive_required_tokens(*q.text, q.whole_words) : std::vector<std::string>{};
+
+    std::vector<const dog::ArchiveBlock*> candidates;
+    for (const auto& block : reader.blocks()) {
+        if (block_may_match(block, q, tag_id, tokens)) {
+            candidates.push_back(&block);
+        }
+    }
+
+    std::vector<std::string> results(candidates.size());
+    std::atomic<std::size_t> next{0};
+    const auto worker = [&] {
+        for (auto i = next.fetch_add(1); i < candidates.size(); i = next.fetch_add(1)) {
+            scan_block(*candidates[i], q, tag_id, results[i]);
+        }
+    };
+    std::vector<std::thread> pool;
+    const auto extra = std::min<std::size_t>(q.threads, candidates.size());
+    for (std::size_t i = 1; i < extra; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+    for (const auto& chunk : results) {
+        std::cout.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    }
+}
+}
+
+int main(int argc, char** argv) {
+    Query q;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto next = [&]() -> std::optional<std::string> {
+            if (i + 1 >= argc) {
+                return std::nullopt;
+            }
+            return std::string{argv[++i]};
+        };
+        try {
+            if (arg == "--from" || arg == "--to" || arg == "--level" || arg == "--tag" ||
+                arg == "--grep" || arg == "--threads") {
+                const auto value = next();
+                if (!value) {
+                    return usage();
+                }
+                if (arg == "--from") {
+                    q.from_ms = std::stoll(*value);
+                } else if (arg == "--to") {
+                    q.to_ms = std::stoll(*value);
+                } else if (arg == "--level") {
+                    dog::LogLevel min_level;
+                    if (!dog::parse_level(*value, min_level)) {
+                        std::cerr << "Unknown level '" << *value << "'" << std::endl;
+                        return usage();
+                    }
+                    q.level_mask = ~(dog::archive_level_bit(min_level) - 1);
+                } else if (arg == "--tag") {
+                    q.tag = *value;
+                } else if (arg == "--grep") {
+                    q.text = *value;
+                } else {
+                    q.threads = std::max(1, std::stoi(*value));
+                }
+            } else if (arg == "-w") {
+                q.whole_words = true;
+            } else if (!arg.empty() && arg[0] == '-') {
+                return usage();
+            } else {
+                files.push_back(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return usage();
+        }
+    }
+    if (files.empty()) {
+        return usage();
+    }
+    for (const auto& file : files) {
+        query_file(file, q);
+    }
+    return 0;
+}